@@ -0,0 +1,71 @@
+#include "Interpolator.h"
+#include <vector>
+
+namespace
+{
+    constexpr double sincCutoff = 0.9;     // Vůči Nyquistově frekvenci; mírná rezerva proti aliasingu
+    constexpr double kaiserBeta = 8.0;
+
+    double besselI0 (double x) noexcept
+    {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 50; ++k)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+            if (term < sum * 1.0e-12)
+                break;
+        }
+
+        return sum;
+    }
+
+    /**
+     * Polyfázová tabulka: řádek p obsahuje váhy bodů pro frac = p / sincPhases.
+     * Bod j leží ve vzdálenosti t = frac + (numTaps / 2 - 1) - j od pozice.
+     * Každý řádek je normalizovaný na jednotkový zisk pro DC.
+     */
+    std::vector<float> buildSincTable (int numTaps)
+    {
+        const int numPhases = Interpolator::sincPhases;
+        const double halfWidth = numTaps / 2;
+        const double windowNorm = besselI0 (kaiserBeta);
+
+        std::vector<float> table ((size_t) ((numPhases + 1) * numTaps));
+
+        for (int phase = 0; phase <= numPhases; ++phase)
+        {
+            const double frac = (double) phase / numPhases;
+            float* row = table.data() + phase * numTaps;
+            double sum = 0.0;
+
+            for (int j = 0; j < numTaps; ++j)
+            {
+                const double t = frac + (halfWidth - 1.0) - j;
+                const double x = t / halfWidth;
+                const double window = std::abs (x) < 1.0 ? besselI0 (kaiserBeta * std::sqrt (1.0 - x * x)) / windowNorm : 0.0;
+                const double arg = juce::MathConstants<double>::pi * sincCutoff * t;
+                const double sinc = std::abs (arg) < 1.0e-9 ? 1.0 : std::sin (arg) / arg;
+
+                row[j] = (float) (sincCutoff * sinc * window);
+                sum += row[j];
+            }
+
+            for (int j = 0; j < numTaps; ++j)
+                row[j] = (float) (row[j] / sum);
+        }
+
+        return table;
+    }
+
+    struct SincTables
+    {
+        std::vector<float> taps8 = buildSincTable (8);
+        std::vector<float> taps16 = buildSincTable (16);
+    };
+
+    // Tabulky vzniknou před spuštěním audio vlákna, render je jen čte
+    const SincTables tables;
+}
+
+const float* const Interpolator::detail::sincTables[2] = { tables.taps8.data(), tables.taps16.data() };
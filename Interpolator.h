@@ -0,0 +1,211 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define ITHACA_INTERPOLATOR_SSE 1
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+ #include <arm_neon.h>
+ #define ITHACA_INTERPOLATOR_NEON 1
+#endif
+
+/**
+ * Kvalita interpolace při přehrávání vzorku s neceločíselným krokem
+ * (pitch, dopočítané noty, rozdílný sample rate souboru a hostitele).
+ */
+enum class InterpolationQuality : juce::uint8
+{
+    Linear = 0,     // 2 body
+    Hermite = 1,    // 4 body, kubický Hermite (Catmull-Rom)
+    Sinc8 = 2,      // 8 bodů, polyfázový windowed-sinc
+    Sinc16 = 3      // 16 bodů, polyfázový windowed-sinc
+};
+
+/**
+ * Interpolační jádra pro render hlasu.
+ *
+ * Kvalita je parametr šablony, takže vnitřní smyčka renderu je pro každou
+ * kvalitu zvlášť specializovaná; engine mezi nimi přepíná za běhu jednou
+ * za blok. Jádro dostane souvislé okno numTaps vzorků začínající na
+ * indexu (index - tapOffset) a zlomkovou pozici frac v intervalu [0, 1).
+ *
+ * process() používá SSE2 (x64 základ), nebo NEON podle cílové platformy -
+ * jádro se volá na každý vzorek a musí se inlinovat, proto bez výběru za běhu
+ * jako MixKernels. processScalar() je referenční implementace; shodu obou
+ * ověřuje IthacaBenchmark --verify-kernels.
+ */
+namespace Interpolator
+{
+   #if ITHACA_INTERPOLATOR_SSE
+    constexpr const char* simdName = "SSE2";
+   #elif ITHACA_INTERPOLATOR_NEON
+    constexpr const char* simdName = "NEON";
+   #else
+    constexpr const char* simdName = "scalar";
+   #endif
+
+    // Počet fází polyfázové sinc tabulky (mezi fázemi se interpoluje lineárně)
+    constexpr int sincPhases = 256;
+
+    namespace detail
+    {
+        // Sinc tabulky pro 8 a 16 bodů, spočítané při statické inicializaci
+        extern const float* const sincTables[2];
+    }
+
+    // Tabulka (sincPhases + 1) x numTaps koeficientů pro 8 nebo 16 bodů
+    inline const float* getSincTable (int numTaps) noexcept
+    {
+        return detail::sincTables[numTaps == 16 ? 1 : 0];
+    }
+
+    //==============================================================================
+    namespace detail
+    {
+        inline float dot4Scalar (const float* a, const float* b) noexcept
+        {
+            return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+        }
+
+        // Skalární součin okna s koeficienty lineárně interpolovanými mezi dvěma fázemi
+        template <int NumTaps>
+        inline float sincScalar (const float* window, float frac) noexcept
+        {
+            const float phase = frac * (float) sincPhases;
+            const int index = juce::jlimit (0, sincPhases - 1, (int) phase);
+            const float phaseFrac = phase - (float) index;
+            const float* c0 = getSincTable (NumTaps) + index * NumTaps;
+            const float* c1 = c0 + NumTaps;
+
+            float sum = 0.0f;
+            for (int i = 0; i < NumTaps; ++i)
+                sum += window[i] * (c0[i] + phaseFrac * (c1[i] - c0[i]));
+
+            return sum;
+        }
+
+       #if ITHACA_INTERPOLATOR_SSE
+        inline float horizontalSum (__m128 v) noexcept
+        {
+            __m128 shuffled = _mm_shuffle_ps (v, v, _MM_SHUFFLE (2, 3, 0, 1));
+            __m128 sums = _mm_add_ps (v, shuffled);
+            shuffled = _mm_movehl_ps (shuffled, sums);
+            sums = _mm_add_ss (sums, shuffled);
+            return _mm_cvtss_f32 (sums);
+        }
+       #elif ITHACA_INTERPOLATOR_NEON
+        inline float horizontalSum (float32x4_t v) noexcept
+        {
+            const float32x2_t pair = vadd_f32 (vget_low_f32 (v), vget_high_f32 (v));
+            return vget_lane_f32 (vpadd_f32 (pair, pair), 0);
+        }
+       #endif
+
+        template <int NumTaps>
+        inline float sincSimd (const float* window, float frac) noexcept
+        {
+            const float phase = frac * (float) sincPhases;
+            const int index = juce::jlimit (0, sincPhases - 1, (int) phase);
+            const float phaseFrac = phase - (float) index;
+            const float* c0 = getSincTable (NumTaps) + index * NumTaps;
+            const float* c1 = c0 + NumTaps;
+
+           #if ITHACA_INTERPOLATOR_SSE
+            const __m128 f = _mm_set1_ps (phaseFrac);
+            __m128 acc = _mm_setzero_ps();
+            for (int i = 0; i < NumTaps; i += 4)
+            {
+                const __m128 a = _mm_loadu_ps (c0 + i);
+                const __m128 coeff = _mm_add_ps (a, _mm_mul_ps (f, _mm_sub_ps (_mm_loadu_ps (c1 + i), a)));
+                acc = _mm_add_ps (acc, _mm_mul_ps (coeff, _mm_loadu_ps (window + i)));
+            }
+            return horizontalSum (acc);
+           #elif ITHACA_INTERPOLATOR_NEON
+            const float32x4_t f = vdupq_n_f32 (phaseFrac);
+            float32x4_t acc = vdupq_n_f32 (0.0f);
+            for (int i = 0; i < NumTaps; i += 4)
+            {
+                const float32x4_t a = vld1q_f32 (c0 + i);
+                const float32x4_t coeff = vmlaq_f32 (a, f, vsubq_f32 (vld1q_f32 (c1 + i), a));
+                acc = vmlaq_f32 (acc, coeff, vld1q_f32 (window + i));
+            }
+            return horizontalSum (acc);
+           #else
+            return sincScalar<NumTaps> (window, frac);
+           #endif
+        }
+    }
+
+    //==============================================================================
+    template <InterpolationQuality Quality>
+    struct Kernel;
+
+    // Nejvíc framů před pozicí, které čte některé jádro (Sinc16) - historie, kterou musí držet ring streamu
+    constexpr int maxTapOffset = 7;
+
+    template <>
+    struct Kernel<InterpolationQuality::Linear>
+    {
+        static constexpr int numTaps = 2;
+        static constexpr int tapOffset = 0;
+
+        static float processScalar (const float* w, float frac) noexcept { return w[0] + frac * (w[1] - w[0]); }
+        static float process (const float* w, float frac) noexcept       { return processScalar (w, frac); }
+    };
+
+    template <>
+    struct Kernel<InterpolationQuality::Hermite>
+    {
+        static constexpr int numTaps = 4;
+        static constexpr int tapOffset = 1;
+
+        static float processScalar (const float* w, float frac) noexcept
+        {
+            const float c1 = 0.5f * (w[2] - w[0]);
+            const float c2 = w[0] - 2.5f * w[1] + 2.0f * w[2] - 0.5f * w[3];
+            const float c3 = 0.5f * (w[3] - w[0]) + 1.5f * (w[1] - w[2]);
+            return ((c3 * frac + c2) * frac + c1) * frac + w[1];
+        }
+
+        static float process (const float* w, float frac) noexcept
+        {
+            // Stejný polynom jako váhy bodů, aby šel spočítat jedním skalárním součinem
+            const float f2 = frac * frac;
+            const float f3 = f2 * frac;
+            alignas (16) const float weights[4] = { -0.5f * f3 + f2 - 0.5f * frac,
+                                                    1.5f * f3 - 2.5f * f2 + 1.0f,
+                                                    -1.5f * f3 + 2.0f * f2 + 0.5f * frac,
+                                                    0.5f * f3 - 0.5f * f2 };
+           #if ITHACA_INTERPOLATOR_SSE
+            return detail::horizontalSum (_mm_mul_ps (_mm_load_ps (weights), _mm_loadu_ps (w)));
+           #elif ITHACA_INTERPOLATOR_NEON
+            return detail::horizontalSum (vmulq_f32 (vld1q_f32 (weights), vld1q_f32 (w)));
+           #else
+            return detail::dot4Scalar (weights, w);
+           #endif
+        }
+    };
+
+    template <>
+    struct Kernel<InterpolationQuality::Sinc8>
+    {
+        static constexpr int numTaps = 8;
+        static constexpr int tapOffset = 3;
+
+        static float processScalar (const float* w, float frac) noexcept { return detail::sincScalar<8> (w, frac); }
+        static float process (const float* w, float frac) noexcept       { return detail::sincSimd<8> (w, frac); }
+    };
+
+    template <>
+    struct Kernel<InterpolationQuality::Sinc16>
+    {
+        static constexpr int numTaps = 16;
+        static constexpr int tapOffset = 7;
+
+        static float processScalar (const float* w, float frac) noexcept { return detail::sincScalar<16> (w, frac); }
+        static float process (const float* w, float frac) noexcept       { return detail::sincSimd<16> (w, frac); }
+    };
+
+    static_assert (Kernel<InterpolationQuality::Sinc16>::tapOffset == maxTapOffset, "maxTapOffset musi pokryt nejdelsi jadro");
+}
@@ -0,0 +1,995 @@
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "Interpolator.h"
+#include "MixKernels.h"
+#include "PluginProcessor.h"
+#include "SampleCodec.h"
+#include "SamplerEngine.h"
+
+#if JUCE_WINDOWS
+ #include <windows.h>
+ #include <psapi.h>
+#else
+ #include <sys/resource.h>
+#endif
+
+/**
+ * IthacaBenchmark - headless měření ceny processBlock mimo DAW.
+ *
+ * Vytvoří AudioPluginAudioProcessor bez editoru, počká na načtení nástroje
+ * a pro každou kombinaci sample rate a velikosti bloku přehraje skriptované
+ * MIDI zátěže (akordy, rychlé opakované noty, clustery se sustain pedálem,
+ * glissanda přes 88 kláves). Výsledek je JSON na stdout nebo do souboru:
+ * ns/blok, realTimeFactor (čas zpracování / délka audia, < 1 = rychlejší
+ * než real-time), p50/p99/max doby bloku a peak RSS procesu. --storage
+ * zvolí formát vzorků v paměti (float32, compact16, native, compressed).
+ *
+ * --compare-synth místo toho srovná samotný SamplerEngine (SoA hlasy,
+ * nevirtuální mix) s juce::Synthesiser (objekt a virtuální renderNextBlock
+ * na hlas) při 16, 64 a 256 současně znějících hlasech. Oba hrají stejný
+ * syntetický vzorek s lineární interpolací, obálkou a gainem L/R, takže
+ * rozdíl je v uspořádání stavu hlasů a režii volání. Engine běží navíc
+ * s týmž vzorkem komprimovaným (SampleCodec) a hlásí p99/max doby bloku -
+ * všechny hlasy začínají v prvním bloku, tedy nejhorší případ dekódování.
+ *
+ * --compare-storage změří cenu převodu při renderu: stejný syntetický tónový
+ * vzorek a počet hlasů (64, 256) ve float32, int16, packed int24 a komprimovaný
+ * (SampleCodec z 24 bitů), s režií vůči float32 v procentech, skutečnou
+ * velikostí dat, p99/max doby bloku a kontrolou bezeztrátovosti komprese.
+ *
+ * --verify-kernels porovná každou verzi MixKernels použitelnou na tomto CPU
+ * (SSE2, AVX2, NEON) se skalární referencí: převody int16/int24 musí být
+ * bitově shodné, mix v toleranci 1e-6. Stejně ověří interpolační jádra
+ * (Hermite, Sinc8, Sinc16 v SSE2 / NEON) proti processScalar() na náhodných
+ * oknech a frac, tolerance 1e-5. Při neshodě končí s kódem 1.
+ *
+ * Použití: IthacaBenchmark [--samples <dir>] [--output <file.json>]
+ *                          [--seconds <n>] [--quick] [--log] [--compare-synth]
+ *                          [--compare-storage] [--verify-kernels]
+ *                          [--storage <float32|compact16|native|compressed>]
+ */
+namespace
+{
+    struct TimedEvent
+    {
+        juce::int64 time = 0;       // Pozice ve vzorcích od začátku zátěže
+        juce::uint8 data[3] = {};
+        int numBytes = 3;
+    };
+
+    struct Workload
+    {
+        const char* name;
+        void (*generate) (std::vector<TimedEvent>& events, double sampleRate, juce::int64 length, juce::Random& random);
+    };
+
+    void addEvent (std::vector<TimedEvent>& events, juce::int64 time, int status, int data1, int data2)
+    {
+        TimedEvent event;
+        event.time = time;
+        event.data[0] = (juce::uint8) status;
+        event.data[1] = (juce::uint8) data1;
+        event.data[2] = (juce::uint8) data2;
+        events.push_back (event);
+    }
+
+    void addNote (std::vector<TimedEvent>& events, juce::int64 time, juce::int64 duration, int note, int velocity)
+    {
+        addEvent (events, time, 0x90, note, velocity);
+        addEvent (events, time + duration, 0x80, note, 0);
+    }
+
+    juce::int64 toSamples (double seconds, double sampleRate) { return (juce::int64) (seconds * sampleRate); }
+
+    // Desetihlasé akordy náhodných not každých 50 ms
+    void generateChordStorm (std::vector<TimedEvent>& events, double sampleRate, juce::int64 length, juce::Random& random)
+    {
+        for (juce::int64 t = 0; t < length; t += toSamples (0.05, sampleRate))
+            for (int i = 0; i < 10; ++i)
+                addNote (events, t, toSamples (0.04, sampleRate), IthacaConfig::MIDI_NOTE_MIN + random.nextInt (88), 40 + random.nextInt (88));
+    }
+
+    // Rychlé opakování několika not (restart same note) - 50 úderů za sekundu
+    void generateRepeatedNotes (std::vector<TimedEvent>& events, double sampleRate, juce::int64 length, juce::Random& random)
+    {
+        int index = 0;
+        for (juce::int64 t = 0; t < length; t += toSamples (0.02, sampleRate), ++index)
+            addNote (events, t, toSamples (0.015, sampleRate), 60 + (index % 4) * 3, 60 + random.nextInt (60));
+    }
+
+    // Clustery 8 sousedních not při stisknutém pedálu, pedál se uvolní každou sekundu
+    void generateSustainClusters (std::vector<TimedEvent>& events, double sampleRate, juce::int64 length, juce::Random& random)
+    {
+        const juce::int64 pedalPeriod = toSamples (1.0, sampleRate);
+
+        for (juce::int64 pedal = 0; pedal < length; pedal += pedalPeriod)
+        {
+            addEvent (events, pedal, 0xb0, 64, 127);
+
+            for (juce::int64 t = pedal; t < juce::jmin (length, pedal + pedalPeriod - toSamples (0.1, sampleRate)); t += toSamples (0.1, sampleRate))
+            {
+                const int base = IthacaConfig::MIDI_NOTE_MIN + random.nextInt (80);
+                for (int i = 0; i < 8; ++i)
+                    addNote (events, t, toSamples (0.05, sampleRate), base + i, 50 + random.nextInt (70));
+            }
+
+            addEvent (events, pedal + pedalPeriod - toSamples (0.05, sampleRate), 0xb0, 64, 0);
+        }
+    }
+
+    // Glissando přes všech 88 kláves nahoru a dolů, nota každých 10 ms
+    void generateGlissando (std::vector<TimedEvent>& events, double sampleRate, juce::int64 length, juce::Random& random)
+    {
+        int step = 0;
+        for (juce::int64 t = 0; t < length; t += toSamples (0.01, sampleRate), ++step)
+        {
+            const int phase = step % 174;
+            const int offset = phase < 88 ? phase : 173 - phase;
+            addNote (events, t, toSamples (0.03, sampleRate), IthacaConfig::MIDI_NOTE_MIN + offset, 70 + random.nextInt (40));
+        }
+    }
+
+    const Workload workloads[] = {
+        { "chordStorm",      generateChordStorm },
+        { "repeatedNotes",   generateRepeatedNotes },
+        { "sustainClusters", generateSustainClusters },
+        { "glissando",       generateGlissando }
+    };
+
+    //==============================================================================
+    // Srovnání s juce::Synthesiser (--compare-synth)
+
+    // Stereo šum s pomalým útlumem; poslední frame je nulový guard (jako u SampleData)
+    std::shared_ptr<juce::AudioBuffer<float>> createTestAudio (int numFrames)
+    {
+        auto audio = std::make_shared<juce::AudioBuffer<float>> (2, numFrames + 1);
+        juce::Random random (0x5a3);
+
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            auto* data = audio->getWritePointer (channel);
+            for (int i = 0; i < numFrames; ++i)
+                data[i] = (random.nextFloat() * 2.0f - 1.0f) * 0.25f * std::exp (-(float) i / (float) numFrames);
+
+            data[numFrames] = 0.0f;
+        }
+
+        return audio;
+    }
+
+    // Tónový signál (harmonické s útlumem a slabý šum) - komprimovatelný podobně jako nahraný nástroj
+    std::shared_ptr<juce::AudioBuffer<float>> createTonalAudio (int numFrames, double sampleRate)
+    {
+        auto audio = std::make_shared<juce::AudioBuffer<float>> (2, numFrames + 1);
+        juce::Random random (0x5a3);
+
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            auto* data = audio->getWritePointer (channel);
+            const double detune = channel == 0 ? 1.0 : 1.002;
+
+            for (int i = 0; i < numFrames; ++i)
+            {
+                const double t = (double) i / sampleRate;
+                double value = 0.0;
+                for (int harmonic = 1; harmonic <= 8; ++harmonic)
+                    value += std::sin (juce::MathConstants<double>::twoPi * 220.0 * detune * harmonic * t) / harmonic;
+
+                data[i] = (float) (0.2 * value * std::exp (-1.5 * t)) + (random.nextFloat() * 2.0f - 1.0f) * 1.0e-4f;
+            }
+
+            data[numFrames] = 0.0f;
+        }
+
+        return audio;
+    }
+
+    // Signál kanálů jako celá čísla v rozsahu bitsPerSample bitů (bez guard frame)
+    std::vector<int> quantizeAudio (const juce::AudioBuffer<float>& audio, int bitsPerSample)
+    {
+        const int numFrames = audio.getNumSamples() - 1;
+        const float fullScale = (float) (1 << (bitsPerSample - 1));
+        std::vector<int> values ((size_t) numFrames * 2);
+
+        for (int channel = 0; channel < 2; ++channel)
+            for (int i = 0; i < numFrames; ++i)
+                values[(size_t) (channel * numFrames + i)] = juce::jlimit ((int) -fullScale, (int) fullScale - 1,
+                                                                           juce::roundToInt (audio.getSample (channel, i) * fullScale));
+
+        return values;
+    }
+
+    // Nástroj s jedním vzorkem na každou klávesu (sdílená data, jedna vrstva).
+    // Celočíselné formáty dostanou stejný signál převedený do sdíleného bloku (kanály za sebou),
+    // komprimovaný formát 24bit signál zakódovaný SampleCodec (oba kanály v jednom bloku).
+    std::unique_ptr<SampleLibrary> createTestLibrary (const std::shared_ptr<juce::AudioBuffer<float>>& audio, double sampleRate,
+                                                      SampleFormat format = SampleFormat::Float32)
+    {
+        const int numFrames = audio->getNumSamples();       // Včetně guard frame
+        const auto channelBytes = format == SampleFormat::Compressed ? 0 : (size_t) numFrames * getBytesPerSample (format);
+        const float fullScale = format == SampleFormat::Int16 ? 32768.0f : 8388608.0f;
+        std::shared_ptr<juce::MemoryBlock> pcm;
+
+        if (format == SampleFormat::Compressed)
+        {
+            const auto values = quantizeAudio (*audio, 24);
+            const int* const channels[2] = { values.data(), values.data() + numFrames - 1 };
+            pcm = std::make_shared<juce::MemoryBlock> (SampleCodec::encode (channels, 2, numFrames - 1, 24));
+        }
+        else if (format != SampleFormat::Float32)
+        {
+            pcm = std::make_shared<juce::MemoryBlock> (channelBytes * 2, true);
+
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                const auto* data = audio->getReadPointer (channel);
+                auto* out = static_cast<juce::uint8*> (pcm->getData()) + channelBytes * (size_t) channel;
+
+                for (int i = 0; i < numFrames; ++i)
+                {
+                    const auto value = (juce::uint32) juce::jlimit ((int) -fullScale, (int) fullScale - 1, juce::roundToInt (data[i] * fullScale));
+
+                    if (format == SampleFormat::Int16)
+                    {
+                        reinterpret_cast<juce::int16*> (out)[i] = (juce::int16) value;
+                    }
+                    else
+                    {
+                        out[3 * i] = (juce::uint8) value;
+                        out[3 * i + 1] = (juce::uint8) (value >> 8);
+                        out[3 * i + 2] = (juce::uint8) (value >> 16);
+                    }
+                }
+            }
+        }
+
+        std::vector<std::shared_ptr<const SampleData>> samples;
+
+        for (int note = IthacaConfig::MIDI_NOTE_MIN; note <= IthacaConfig::MIDI_NOTE_MAX; ++note)
+        {
+            auto sample = std::make_shared<SampleData>();
+            sample->midiNote = note;
+            sample->sampleRate = sampleRate;
+            sample->numFrames = numFrames - 1;
+            sample->residentFrames = sample->numFrames;
+            sample->numChannels = 2;
+            sample->format = format;
+
+            if (pcm != nullptr)
+            {
+                sample->scale = 1.0f / fullScale;
+                sample->channelData[0] = pcm->getData();
+                sample->channelData[1] = static_cast<const char*> (pcm->getData()) + channelBytes;
+                sample->storage = pcm;
+            }
+            else
+            {
+                sample->channelData[0] = audio->getReadPointer (0);
+                sample->channelData[1] = audio->getReadPointer (1);
+                sample->storage = audio;
+            }
+
+            samples.push_back (std::move (sample));
+        }
+
+        return SampleLibrary::createFromSamples ({}, 0, std::move (samples));
+    }
+
+    struct BaselineSound : public juce::SynthesiserSound
+    {
+        bool appliesToNote (int) override    { return true; }
+        bool appliesToChannel (int) override { return true; }
+    };
+
+    // Obvyklý hlas juce::Synthesiser: stejná práce jako hlas enginu (lineární interpolace, ADSR, gain L/R)
+    class BaselineVoice : public juce::SynthesiserVoice
+    {
+    public:
+        explicit BaselineVoice (const juce::AudioBuffer<float>& sourceAudio) : audio (sourceAudio) {}
+
+        bool canPlaySound (juce::SynthesiserSound* sound) override { return dynamic_cast<BaselineSound*> (sound) != nullptr; }
+
+        void startNote (int, float velocity, juce::SynthesiserSound*, int) override
+        {
+            position = 0.0;
+            gainL = gainR = velocity;
+            adsr.setSampleRate (getSampleRate());
+            adsr.setParameters ({ 0.001f, 1.0f, 1.0f, 0.25f });
+            adsr.noteOn();
+        }
+
+        void stopNote (float, bool allowTailOff) override
+        {
+            if (allowTailOff)
+            {
+                adsr.noteOff();
+            }
+            else
+            {
+                adsr.reset();
+                clearCurrentNote();
+            }
+        }
+
+        void pitchWheelMoved (int) override {}
+        void controllerMoved (int, int) override {}
+
+        void renderNextBlock (juce::AudioBuffer<float>& output, int startSample, int numSamples) override
+        {
+            if (! isVoiceActive())
+                return;
+
+            const float* inL = audio.getReadPointer (0);
+            const float* inR = audio.getReadPointer (1);
+            float* outL = output.getWritePointer (0, startSample);
+            float* outR = output.getWritePointer (1, startSample);
+            const int numFrames = audio.getNumSamples() - 1;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const int index = (int) position;
+                if (index >= numFrames || ! adsr.isActive())
+                {
+                    clearCurrentNote();
+                    break;
+                }
+
+                const float frac = (float) (position - (double) index);
+                const float envelope = adsr.getNextSample();
+                outL[i] += (inL[index] + frac * (inL[index + 1] - inL[index])) * gainL * envelope;
+                outR[i] += (inR[index] + frac * (inR[index + 1] - inR[index])) * gainR * envelope;
+                position += 1.0;
+            }
+        }
+
+    private:
+        const juce::AudioBuffer<float>& audio;
+        juce::ADSR adsr;
+        double position = 0.0;
+        float gainL = 1.0f, gainR = 1.0f;
+    };
+
+    // Note-on pro numVoices různých (kanál, nota) - v rámci 88 kláves se střídají kanály
+    juce::MidiBuffer createVoiceNotes (int numVoices)
+    {
+        juce::MidiBuffer midi;
+        for (int i = 0; i < numVoices; ++i)
+            midi.addEvent (juce::MidiMessage::noteOn (1 + i / 88, IthacaConfig::MIDI_NOTE_MIN + i % 88, (juce::uint8) 100), 0);
+
+        return midi;
+    }
+
+    double percentile (std::vector<double> sorted, double fraction)
+    {
+        if (sorted.empty())
+            return 0.0;
+
+        std::sort (sorted.begin(), sorted.end());
+        const auto index = (size_t) juce::jlimit (0.0, (double) sorted.size() - 1.0, std::ceil (fraction * (double) sorted.size()) - 1.0);
+        return sorted[index];
+    }
+
+    // Průměrný čas bloku (ns); první blok obsahuje note-on všech hlasů. blockNanos (volitelně) dostane doby všech bloků.
+    template <typename RenderFunction>
+    double timeBlocks (int numBlocks, int blockSize, RenderFunction&& render, std::vector<double>* blockNanos = nullptr)
+    {
+        juce::AudioBuffer<float> buffer (2, blockSize);
+        const double ticksToNanos = 1.0e9 / (double) juce::Time::getHighResolutionTicksPerSecond();
+        double totalNanos = 0.0;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            buffer.clear();
+            const auto start = juce::Time::getHighResolutionTicks();
+            render (buffer, block);
+            const double nanos = (double) (juce::Time::getHighResolutionTicks() - start) * ticksToNanos;
+            totalNanos += nanos;
+
+            if (blockNanos != nullptr)
+                blockNanos->push_back (nanos);
+        }
+
+        return numBlocks > 0 ? totalNanos / numBlocks : 0.0;
+    }
+
+    // Doby bloků jednoho běhu enginu (ns)
+    struct BlockTimes
+    {
+        double mean = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+    };
+
+    // Čas bloku SamplerEngine; activeVoices = hlasy znějící na konci (kontrola mimo měření)
+    BlockTimes timeEngine (const SampleLibrary& library, InterpolationQuality quality, double sampleRate, int blockSize,
+                           int numVoices, int numBlocks, int& activeVoices, SampleStorage storage = SampleStorage::Native)
+    {
+        const auto notes = createVoiceNotes (numVoices);
+        const juce::MidiBuffer noMidi;
+
+        SamplerSettings settings;
+        settings.maxVoices = numVoices;
+        settings.interpolationQuality = quality;
+        settings.streamFromDisk = false;
+        settings.sampleStorage = storage;
+
+        SamplerEngine engine;
+        engine.prepare (sampleRate, blockSize, settings);
+        engine.setLibrary (&library);
+
+        std::vector<double> blockNanos;
+        blockNanos.reserve ((size_t) numBlocks);
+
+        BlockTimes times;
+        times.mean = timeBlocks (numBlocks, blockSize, [&] (juce::AudioBuffer<float>& buffer, int block)
+        {
+            engine.renderBlock (buffer, block == 0 ? notes : noMidi);
+        }, &blockNanos);
+
+        times.p99 = percentile (blockNanos, 0.99);
+        times.max = blockNanos.empty() ? 0.0 : *std::max_element (blockNanos.begin(), blockNanos.end());
+
+        activeVoices = engine.getNumActiveVoices();
+        engine.setLibrary (nullptr);
+        return times;
+    }
+
+    juce::var compareWithSynthesiser (double sampleRate, int blockSize, int numVoices, double seconds)
+    {
+        const int numBlocks = (int) (seconds * sampleRate) / blockSize;
+        const auto audio = createTestAudio ((int) ((seconds + 1.0) * sampleRate));
+        const auto notes = createVoiceNotes (numVoices);
+        const juce::MidiBuffer noMidi;
+
+        // SamplerEngine se stejnou kvalitou interpolace jako baseline
+        const auto library = createTestLibrary (audio, sampleRate);
+        int engineVoices = 0;
+        const auto engineTimes = timeEngine (*library, InterpolationQuality::Linear, sampleRate, blockSize,
+                                             numVoices, numBlocks, engineVoices);
+        const double engineNanos = engineTimes.mean;
+
+        // Týž signál komprimovaný (SampleCodec); všechny hlasy začínají v prvním bloku zároveň
+        const auto compressedLibrary = createTestLibrary (audio, sampleRate, SampleFormat::Compressed);
+        int compressedVoices = 0;
+        const auto compressedTimes = timeEngine (*compressedLibrary, InterpolationQuality::Linear, sampleRate, blockSize,
+                                                 numVoices, numBlocks, compressedVoices, SampleStorage::Compressed);
+
+        juce::Synthesiser synth;
+        synth.setCurrentPlaybackSampleRate (sampleRate);
+        synth.addSound (new BaselineSound());
+        for (int i = 0; i < numVoices; ++i)
+            synth.addVoice (new BaselineVoice (*audio));
+
+        const double synthNanos = timeBlocks (numBlocks, blockSize, [&] (juce::AudioBuffer<float>& buffer, int block)
+        {
+            synth.renderNextBlock (buffer, block == 0 ? notes : noMidi, 0, blockSize);
+        });
+
+        int synthVoices = 0;
+        for (int i = 0; i < synth.getNumVoices(); ++i)
+            synthVoices += synth.getVoice (i)->isVoiceActive() ? 1 : 0;
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty ("voices", numVoices);
+        result->setProperty ("sampleRate", sampleRate);
+        result->setProperty ("blockSize", blockSize);
+        result->setProperty ("blocks", numBlocks);
+        result->setProperty ("engineNsPerBlock", engineNanos);
+        result->setProperty ("synthesiserNsPerBlock", synthNanos);
+        result->setProperty ("speedup", engineNanos > 0.0 ? synthNanos / engineNanos : 0.0);
+        result->setProperty ("engineP99Ns", engineTimes.p99);
+        result->setProperty ("engineMaxNs", engineTimes.max);
+        result->setProperty ("compressedNsPerBlock", compressedTimes.mean);
+        result->setProperty ("compressedP99Ns", compressedTimes.p99);
+        result->setProperty ("compressedMaxNs", compressedTimes.max);
+        result->setProperty ("deadlineNs", (double) blockSize / sampleRate * 1.0e9);
+        result->setProperty ("engineActiveVoices", engineVoices);
+        result->setProperty ("compressedActiveVoices", compressedVoices);
+        result->setProperty ("synthesiserActiveVoices", synthVoices);
+        return juce::var (result);
+    }
+
+    //==============================================================================
+    // Cena nativního formátu vzorků (--compare-storage)
+
+    // Dekódování komprimovaného vzorku zpět musí dát přesně původní 24bit hodnoty
+    bool isLosslessRoundTrip (const juce::AudioBuffer<float>& audio, const SampleData& sample)
+    {
+        const auto values = quantizeAudio (audio, 24);
+        const int numFrames = sample.numFrames;
+        std::vector<int> decoded ((size_t) SampleCodec::blockFrames * 2);
+        int* const channels[2] = { decoded.data(), decoded.data() + SampleCodec::blockFrames };
+
+        for (int start = 0; start < numFrames; start += SampleCodec::blockFrames)
+        {
+            const int blockFrames = SampleCodec::decodeBlock (sample.channelData[0], start / SampleCodec::blockFrames, channels);
+            if (blockFrames != juce::jmin (SampleCodec::blockFrames, numFrames - start))
+                return false;
+
+            for (int channel = 0; channel < 2; ++channel)
+                if (! std::equal (channels[channel], channels[channel] + blockFrames,
+                                  values.data() + (size_t) (channel * numFrames + start)))
+                    return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Stejný signál a počet hlasů ve float32, int16, packed int24 a komprimovaný
+     * (SampleCodec); převod na float běží při renderu hlasu. overheadPercent je
+     * čas bloku vůči float32, memoryRatio velikost dat vůči float32.
+     */
+    juce::var compareStorageFormats (double sampleRate, int blockSize, int numVoices, double seconds)
+    {
+        const int numBlocks = (int) (seconds * sampleRate) / blockSize;
+        const auto audio = createTonalAudio ((int) ((seconds + 1.0) * sampleRate), sampleRate);
+        const auto floatBytes = sizeof (float) * 2 * (size_t) audio->getNumSamples();
+
+        juce::Array<juce::var> formats;
+        double floatNanos = 0.0;
+
+        for (auto format : { SampleFormat::Float32, SampleFormat::Int16, SampleFormat::Int24, SampleFormat::Compressed })
+        {
+            const bool compressed = format == SampleFormat::Compressed;
+            const auto library = createTestLibrary (audio, sampleRate, format);
+            int activeVoices = 0;
+            const auto times = timeEngine (*library, InterpolationQuality::Hermite, sampleRate, blockSize, numVoices, numBlocks,
+                                           activeVoices, compressed ? SampleStorage::Compressed : SampleStorage::Native);
+            const double nanos = times.mean;
+
+            if (format == SampleFormat::Float32)
+                floatNanos = nanos;
+
+            const auto& sample = *library->getSamples().front();
+            const auto pcmBytes = compressed ? SampleCodec::getEncodedSize (sample.channelData[0])
+                                             : getBytesPerSample (format) * 2 * (size_t) audio->getNumSamples();
+            const char* names[] = { "float32", "int16", "int24", "compressed24" };
+
+            auto* result = new juce::DynamicObject();
+            result->setProperty ("format", names[(int) format]);
+            result->setProperty ("nsPerBlock", nanos);
+            result->setProperty ("overheadPercent", floatNanos > 0.0 ? (nanos / floatNanos - 1.0) * 100.0 : 0.0);
+            result->setProperty ("p99Ns", times.p99);
+            result->setProperty ("maxNs", times.max);
+            result->setProperty ("pcmBytes", (juce::int64) pcmBytes);
+            result->setProperty ("memoryRatio", (double) pcmBytes / (double) floatBytes);
+            result->setProperty ("activeVoices", activeVoices);
+
+            if (compressed)
+            {
+                result->setProperty ("ratioToInt24", (double) pcmBytes / (3.0 * 2.0 * audio->getNumSamples()));
+                result->setProperty ("lossless", isLosslessRoundTrip (*audio, sample));
+            }
+
+            formats.add (juce::var (result));
+        }
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty ("voices", numVoices);
+        result->setProperty ("sampleRate", sampleRate);
+        result->setProperty ("blockSize", blockSize);
+        result->setProperty ("blocks", numBlocks);
+        result->setProperty ("deadlineNs", (double) blockSize / sampleRate * 1.0e9);
+        result->setProperty ("formats", formats);
+        return juce::var (result);
+    }
+
+    //==============================================================================
+    // Ověření vektorových jader MixKernels proti skalární verzi (--verify-kernels)
+
+    // Největší odchylka mixu od skalární verze (převody musí být přesně shodné, jinak vrací -1)
+    float compareKernels (const MixKernels::Functions& kernels, int numSamples, int offset, juce::Random& random)
+    {
+        const auto& reference = MixKernels::getScalar();
+        const auto size = (size_t) (numSamples + offset);
+
+        auto randomFloats = [&random, size]
+        {
+            std::vector<float> values (size);
+            for (auto& value : values)
+                value = random.nextFloat() * 2.0f - 1.0f;
+            return values;
+        };
+
+        const auto source = randomFloats();
+        auto expectedL = randomFloats(), expectedR = randomFloats();
+        auto actualL = expectedL, actualR = expectedR;
+        const float gain = random.nextFloat(), gainStep = (random.nextFloat() - 0.5f) * 0.01f;
+        const float leftGain = random.nextFloat() * 1.5f, rightGain = random.nextFloat() * 1.5f;
+
+        reference.mixAddRamp (expectedL.data() + offset, source.data() + offset, numSamples, gain, gainStep);
+        kernels.mixAddRamp (actualL.data() + offset, source.data() + offset, numSamples, gain, gainStep);
+        reference.mixAddPanned (expectedL.data() + offset, expectedR.data() + offset, source.data() + offset, numSamples,
+                                gain, gainStep, leftGain, rightGain);
+        kernels.mixAddPanned (actualL.data() + offset, actualR.data() + offset, source.data() + offset, numSamples,
+                              gain, gainStep, leftGain, rightGain);
+
+        float maxError = 0.0f;
+        for (size_t i = 0; i < size; ++i)
+            maxError = juce::jmax (maxError, std::abs (expectedL[i] - actualL[i]), std::abs (expectedR[i] - actualR[i]));
+
+        // Převody - přesně velký vstup (int24 čte 3 bajty na vzorek), aby se odhalilo čtení za koncem
+        std::vector<juce::int16> int16Source (size);
+        for (auto& value : int16Source)
+            value = (juce::int16) random.nextInt (65536);
+
+        std::vector<juce::uint8> int24Source (size * 3);
+        for (auto& value : int24Source)
+            value = (juce::uint8) random.nextInt (256);
+
+        std::vector<float> expected ((size_t) numSamples), actual ((size_t) numSamples);
+
+        reference.int16ToFloat (expected.data(), int16Source.data() + offset, numSamples, 1.0f / 32768.0f);
+        kernels.int16ToFloat (actual.data(), int16Source.data() + offset, numSamples, 1.0f / 32768.0f);
+        if (expected != actual)
+            return -1.0f;
+
+        reference.int24ToFloat (expected.data(), int24Source.data() + 3 * offset, numSamples, 1.0f / 8388608.0f);
+        kernels.int24ToFloat (actual.data(), int24Source.data() + 3 * offset, numSamples, 1.0f / 8388608.0f);
+        if (expected != actual)
+            return -1.0f;
+
+        return maxError;
+    }
+
+    // Průměrný čas mixAddRamp na vzorek (ns) - buffer se vejde do L1
+    double timeMixAddRamp (const MixKernels::Functions& kernels)
+    {
+        constexpr int numSamples = 256, numRuns = 20000;
+        std::vector<float> source ((size_t) numSamples, 0.25f), destination ((size_t) numSamples, 0.0f);
+
+        const auto start = juce::Time::getHighResolutionTicks();
+        for (int run = 0; run < numRuns; ++run)
+            kernels.mixAddRamp (destination.data(), source.data(), numSamples, 0.5f, 1.0e-6f);
+
+        const auto ticks = juce::Time::getHighResolutionTicks() - start;
+        return (double) ticks * 1.0e9 / (double) juce::Time::getHighResolutionTicksPerSecond() / (numSamples * (double) numRuns);
+    }
+
+    // Délky 0-67 pokryjí všechny zbytky za vektorovou smyčkou, posuny 0-2 nezarovnané ukazatele
+    bool verifyKernels (juce::Array<juce::var>& results)
+    {
+        constexpr float tolerance = 1.0e-6f;
+        juce::Random random (0x1ace);
+        bool allPassed = true;
+
+        for (auto* kernels : MixKernels::getAvailable())
+        {
+            float maxError = 0.0f;
+            bool conversionsExact = true;
+
+            for (int numSamples = 0; numSamples <= 68; ++numSamples)
+            {
+                for (int offset = 0; offset < 3; ++offset)
+                {
+                    const float error = compareKernels (*kernels, numSamples == 68 ? 1000 : numSamples, offset, random);
+                    conversionsExact = conversionsExact && error >= 0.0f;
+                    maxError = juce::jmax (maxError, error);
+                }
+            }
+
+            const bool passed = conversionsExact && maxError <= tolerance;
+            allPassed = allPassed && passed;
+
+            auto* result = new juce::DynamicObject();
+            result->setProperty ("kernels", juce::String (kernels->name));
+            result->setProperty ("selected", kernels == &MixKernels::get());
+            result->setProperty ("passed", passed);
+            result->setProperty ("conversionsExact", conversionsExact);
+            result->setProperty ("maxMixError", maxError);
+            result->setProperty ("mixAddRampNsPerSample", timeMixAddRamp (*kernels));
+            results.add (juce::var (result));
+        }
+
+        return allPassed;
+    }
+
+    // Největší odchylka process() od processScalar() jádra na náhodných oknech (hodnoty -1..1)
+    // a frac včetně krajních 0 a těsně pod 1; okno posunuté o 1 float ověří nezarovnané čtení
+    template <InterpolationQuality Quality>
+    juce::var verifyInterpolator (const char* name, juce::Random& random, bool& allPassed)
+    {
+        using Kernel = Interpolator::Kernel<Quality>;
+        constexpr float tolerance = 1.0e-5f;
+        constexpr int numWindows = 100000;
+
+        float buffer[Kernel::numTaps + 1];
+        float maxError = 0.0f;
+
+        for (int run = 0; run < numWindows; ++run)
+        {
+            for (auto& value : buffer)
+                value = random.nextFloat() * 2.0f - 1.0f;
+
+            const float frac = run % 8 == 0 ? 0.0f
+                             : run % 8 == 1 ? std::nextafter (1.0f, 0.0f)
+                                            : random.nextFloat();
+            const float* window = buffer + (run & 1);
+
+            maxError = juce::jmax (maxError, std::abs (Kernel::process (window, frac) - Kernel::processScalar (window, frac)));
+        }
+
+        const bool passed = maxError <= tolerance;
+        allPassed = allPassed && passed;
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty ("quality", juce::String (name));
+        result->setProperty ("kernels", juce::String (Interpolator::simdName));
+        result->setProperty ("passed", passed);
+        result->setProperty ("maxError", maxError);
+        return juce::var (result);
+    }
+
+    // Interpolační jádra (SSE2 / NEON podle platformy) proti skalární referenci
+    bool verifyInterpolators (juce::Array<juce::var>& results)
+    {
+        juce::Random random (0x1e7a);
+        bool allPassed = true;
+
+        results.add (verifyInterpolator<InterpolationQuality::Linear> ("linear", random, allPassed));
+        results.add (verifyInterpolator<InterpolationQuality::Hermite> ("hermite", random, allPassed));
+        results.add (verifyInterpolator<InterpolationQuality::Sinc8> ("sinc8", random, allPassed));
+        results.add (verifyInterpolator<InterpolationQuality::Sinc16> ("sinc16", random, allPassed));
+        return allPassed;
+    }
+
+    //==============================================================================
+    juce::int64 getPeakResidentBytes()
+    {
+       #if JUCE_WINDOWS
+        PROCESS_MEMORY_COUNTERS counters {};
+        if (GetProcessMemoryInfo (GetCurrentProcess(), &counters, sizeof (counters)))
+            return (juce::int64) counters.PeakWorkingSetSize;
+        return 0;
+       #else
+        struct rusage usage {};
+        getrusage (RUSAGE_SELF, &usage);
+        #if JUCE_MAC
+         return (juce::int64) usage.ru_maxrss;          // bajty
+        #else
+         return (juce::int64) usage.ru_maxrss * 1024;   // kB
+        #endif
+       #endif
+    }
+
+    int writeReport (const juce::ArgumentList& args, juce::DynamicObject* report)
+    {
+        const auto json = juce::JSON::toString (juce::var (report));
+
+        if (args.containsOption ("--output"))
+        {
+            const auto outputFile = args.getFileForOption ("--output");
+            if (! outputFile.replaceWithText (json))
+            {
+                std::cerr << "Zapis vysledku selhal: " << outputFile.getFullPathName() << std::endl;
+                return 1;
+            }
+        }
+        else
+        {
+            std::cout << json << std::endl;
+        }
+
+        return 0;
+    }
+
+    /**
+     * Jedna zátěž: MIDI se rozdělí do bloků a měří se čistý čas processBlock.
+     */
+    juce::var runWorkload (AudioPluginAudioProcessor& processor, const Workload& workload,
+                           double sampleRate, int blockSize, double seconds)
+    {
+        const juce::int64 length = toSamples (seconds, sampleRate);
+        std::vector<TimedEvent> events;
+        juce::Random random (0x1ca);
+        workload.generate (events, sampleRate, length, random);
+        std::stable_sort (events.begin(), events.end(), [] (const TimedEvent& a, const TimedEvent& b) { return a.time < b.time; });
+
+        juce::AudioBuffer<float> buffer (2, blockSize);
+        juce::MidiBuffer midi;
+        midi.ensureSize (events.size() * 4 + 64);
+
+        const int numBlocks = (int) ((length + blockSize - 1) / blockSize);
+        std::vector<double> blockNanos;
+        blockNanos.reserve ((size_t) numBlocks);
+
+        const double ticksToNanos = 1.0e9 / (double) juce::Time::getHighResolutionTicksPerSecond();
+        size_t next = 0;
+        int maxEventsPerBlock = 0;
+        processor.getPerformanceMonitor().resetPeaks();
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            const juce::int64 blockStart = (juce::int64) block * blockSize;
+            midi.clear();
+
+            while (next < events.size() && events[next].time < blockStart + blockSize)
+            {
+                const auto& event = events[next++];
+                midi.addEvent (event.data, event.numBytes, (int) juce::jmax ((juce::int64) 0, event.time - blockStart));
+            }
+
+            maxEventsPerBlock = juce::jmax (maxEventsPerBlock, midi.getNumEvents());
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            processor.processBlock (buffer, midi);
+            blockNanos.push_back ((double) (juce::Time::getHighResolutionTicks() - start) * ticksToNanos);
+        }
+
+        const auto perf = processor.getPerformanceMonitor().getSnapshot();
+
+        // Umlčení před další zátěží (mimo měření)
+        midi.clear();
+        for (int channel = 1; channel <= 16; ++channel)
+        {
+            midi.addEvent (juce::MidiMessage::controllerEvent (channel, 64, 0), 0);
+            midi.addEvent (juce::MidiMessage::allSoundOff (channel), 0);
+        }
+
+        processor.processBlock (buffer, midi);
+        midi.clear();
+        for (int i = 0; i < (int) (0.2 * sampleRate) / blockSize + 1; ++i)
+            processor.processBlock (buffer, midi);
+
+        double totalNanos = 0.0;
+        for (auto nanos : blockNanos)
+            totalNanos += nanos;
+
+        const double audioNanos = (double) numBlocks * blockSize / sampleRate * 1.0e9;
+        const double maxNanos = blockNanos.empty() ? 0.0 : *std::max_element (blockNanos.begin(), blockNanos.end());
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty ("workload", workload.name);
+        result->setProperty ("sampleRate", sampleRate);
+        result->setProperty ("blockSize", blockSize);
+        result->setProperty ("blocks", numBlocks);
+        result->setProperty ("midiEvents", (int) events.size());
+        result->setProperty ("maxEventsPerBlock", maxEventsPerBlock);
+        result->setProperty ("nsPerBlock", numBlocks > 0 ? totalNanos / numBlocks : 0.0);
+        result->setProperty ("realTimeFactor", audioNanos > 0.0 ? totalNanos / audioNanos : 0.0);
+        result->setProperty ("p50Ns", percentile (blockNanos, 0.50));
+        result->setProperty ("p99Ns", percentile (blockNanos, 0.99));
+        result->setProperty ("maxNs", maxNanos);
+        result->setProperty ("deadlineNs", (double) blockSize / sampleRate * 1.0e9);
+        result->setProperty ("overloadedBlocks", (juce::int64) perf.overloadedBlocks);
+        result->setProperty ("peakVoices", perf.peakVoices);
+        result->setProperty ("streamUnderruns", (juce::int64) perf.streamUnderruns);
+        result->setProperty ("monitorP99Load", perf.p99Load);
+        return juce::var (result);
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    juce::ArgumentList args (argc, argv);
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    // Logování do GUI bufferu by zkreslovalo měření
+    Logger::loggingEnabled = args.containsOption ("--log");
+
+    const bool quick = args.containsOption ("--quick");
+    const double seconds = args.containsOption ("--seconds") ? juce::jmax (0.5, args.getValueForOption ("--seconds").getDoubleValue())
+                                                             : (quick ? 2.0 : 10.0);
+
+    const std::vector<double> sampleRates = quick ? std::vector<double> { 48000.0 }
+                                                  : std::vector<double> { 44100.0, 48000.0, 96000.0 };
+    const std::vector<int> blockSizes = quick ? std::vector<int> { 256 }
+                                              : std::vector<int> { 64, 128, 256, 512, 1024 };
+
+    if (args.containsOption ("--verify-kernels"))
+    {
+        juce::Array<juce::var> results, interpolators;
+        const bool kernelsPassed = verifyKernels (results);
+        const bool passed = verifyInterpolators (interpolators) && kernelsPassed;
+
+        auto* report = new juce::DynamicObject();
+        report->setProperty ("cpu", juce::SystemStats::getCpuModel());
+        report->setProperty ("passed", passed);
+        report->setProperty ("kernels", results);
+        report->setProperty ("interpolators", interpolators);
+
+        const int result = writeReport (args, report);
+        return passed ? result : 1;
+    }
+
+    if (args.containsOption ("--compare-storage"))
+    {
+        juce::Array<juce::var> results;
+
+        for (auto blockSize : blockSizes)
+            for (int numVoices : { 64, 256 })
+                results.add (compareStorageFormats (48000.0, blockSize, numVoices, seconds));
+
+        auto* report = new juce::DynamicObject();
+        report->setProperty ("cpu", juce::SystemStats::getCpuModel());
+        report->setProperty ("kernels", juce::String (MixKernels::get().name));
+        report->setProperty ("secondsPerRun", seconds);
+        report->setProperty ("storageFormats", results);
+        return writeReport (args, report);
+    }
+
+    if (args.containsOption ("--compare-synth"))
+    {
+        juce::Array<juce::var> results;
+
+        for (auto blockSize : blockSizes)
+            for (int numVoices : { 16, 64, 256 })
+                results.add (compareWithSynthesiser (48000.0, blockSize, numVoices, seconds));
+
+        auto* report = new juce::DynamicObject();
+        report->setProperty ("cpu", juce::SystemStats::getCpuModel());
+        report->setProperty ("os", juce::SystemStats::getOperatingSystemName());
+        report->setProperty ("secondsPerRun", seconds);
+        report->setProperty ("voiceScaling", results);
+        return writeReport (args, report);
+    }
+
+    auto processor = std::make_unique<AudioPluginAudioProcessor>();
+
+    if (args.containsOption ("--samples"))
+    {
+        auto settings = processor->getSamplerSettings();
+        settings.sampleDirectory = args.getExistingFileForOption ("--samples");
+        processor->setSamplerSettings (settings);
+    }
+
+    // Formát vzorků v paměti pro zátěže (např. --storage compressed pro cenu dekódování při chordStorm)
+    if (args.containsOption ("--storage"))
+    {
+        const auto name = args.getValueForOption ("--storage").toLowerCase();
+        const juce::StringArray names { "float32", "compact16", "native", "compressed" };
+
+        if (! names.contains (name))
+        {
+            std::cerr << "Neznamy format --storage: " << name << " (float32, compact16, native, compressed)" << std::endl;
+            return 1;
+        }
+
+        auto settings = processor->getSamplerSettings();
+        settings.sampleStorage = (SampleStorage) names.indexOf (name);
+        processor->setSamplerSettings (settings);
+    }
+
+    juce::Array<juce::var> results;
+
+    for (auto sampleRate : sampleRates)
+    {
+        for (auto blockSize : blockSizes)
+        {
+            processor->setPlayConfigDetails (0, 2, sampleRate, blockSize);
+            processor->prepareToPlay (sampleRate, blockSize);
+
+            if (! processor->waitUntilLibraryLoaded (10 * 60 * 1000))
+            {
+                std::cerr << "Nastroj se nepodarilo nacist vcas" << std::endl;
+                return 1;
+            }
+
+            for (const auto& workload : workloads)
+                results.add (runWorkload (*processor, workload, sampleRate, blockSize, seconds));
+
+            processor->releaseResources();
+        }
+    }
+
+    auto* report = new juce::DynamicObject();
+    report->setProperty ("cpu", juce::SystemStats::getCpuModel());
+    report->setProperty ("os", juce::SystemStats::getOperatingSystemName());
+    report->setProperty ("sampleDirectory", processor->getSamplerSettings().sampleDirectory.getFullPathName());
+    report->setProperty ("librarySamples", processor->getLibraryLoadProgress().filesTotal);
+    report->setProperty ("maxVoices", processor->getSamplerSettings().maxVoices);
+    report->setProperty ("sampleStorage", (int) processor->getSamplerSettings().sampleStorage);
+    report->setProperty ("secondsPerWorkload", seconds);
+    report->setProperty ("peakRssBytes", getPeakResidentBytes());
+    report->setProperty ("results", results);
+
+    processor.reset();
+    return writeReport (args, report);
+}
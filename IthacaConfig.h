@@ -0,0 +1,69 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+/**
+ * Konfigurační konstanty IthacaPlayeru (viz DESIGN7.md, "Konfigurační systém").
+ */
+namespace IthacaConfig
+{
+    constexpr int MAX_VOICES = 16;
+    constexpr int MAX_POLYPHONY = 256;     // Horní mez nastavitelné polyfonie
+    constexpr int MIDI_VELOCITY_MAX = 127;
+    constexpr int MAX_PITCH_SHIFT = 12;
+    constexpr int MIDI_NOTE_MIN = 21;     // A0
+    constexpr int MIDI_NOTE_MAX = 108;    // C8
+    constexpr const char* TEMP_DIR_NAME = "samples_tmp";
+
+    // Fade-out ukradeného hlasu (voice stealing bez kliknutí)
+    constexpr double STEAL_FADE_SECONDS = 0.005;
+
+    // Rozsah pitch bendu (+-půltóny) a nejkratší segment renderu mezi MIDI událostmi
+    constexpr double PITCH_BEND_RANGE_SEMITONES = 2.0;
+    constexpr int MIN_RENDER_SEGMENT_SAMPLES = 16;
+
+    // Sustain pedál (CC64) jako spojitá hodnota 0-1: pod OFF tlumítka dosedají (běžný release),
+    // nad FULL nepřekážejí; mezi nimi half-pedal - release se zpomaluje s hloubkou pedálu
+    constexpr float SUSTAIN_PEDAL_OFF_LEVEL = 0.25f;
+    constexpr float SUSTAIN_PEDAL_FULL_LEVEL = 0.75f;
+
+    // Half-pedal zpomalí release nejvýš na tento podíl rychlosti - doznívání zůstane konečné
+    // (nejvýš release time / tato hodnota, hlásí getTailLengthSeconds)
+    constexpr float HALF_PEDAL_MIN_RELEASE_SPEED = 1.0f / 16.0f;
+
+    // Soft pedál (CC67): násobek velocity nových not při plně stisknutém pedálu
+    constexpr float SOFT_PEDAL_VELOCITY_SCALE = 0.7f;
+
+    // Nejvýš tolik současně znějících úderů jedné noty držených pedálem (opakované údery)
+    constexpr int MAX_PEDAL_STRIKES_PER_NOTE = 3;
+
+    /**
+     * Výchozí adresář se vzorky: %APPDATA%/IthacaPlayer/samples
+     */
+    inline juce::File getDefaultSampleDirectory()
+    {
+        return juce::File::getSpecialLocation (juce::File::userApplicationDataDirectory)
+                   .getChildFile ("IthacaPlayer")
+                   .getChildFile ("samples");
+    }
+
+    /**
+     * Adresář cache: %APPDATA%/IthacaPlayer/samples_tmp
+     */
+    inline juce::File getCacheDirectory()
+    {
+        return juce::File::getSpecialLocation (juce::File::userApplicationDataDirectory)
+                   .getChildFile ("IthacaPlayer")
+                   .getChildFile (TEMP_DIR_NAME);
+    }
+
+    /**
+     * Adresář journalu logu: %APPDATA%/IthacaPlayer/logs
+     */
+    inline juce::File getLogJournalDirectory()
+    {
+        return juce::File::getSpecialLocation (juce::File::userApplicationDataDirectory)
+                   .getChildFile ("IthacaPlayer")
+                   .getChildFile ("logs");
+    }
+}
@@ -0,0 +1,236 @@
+#include <juce_core/juce_core.h>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "IthacaConfig.h"
+#include "LogJournal.h"
+
+/**
+ * IthacaLogDecoder - převod binárního journalu logu (LogJournal) na text nebo CSV.
+ *
+ * Vstupem jsou soubory *.ithj nebo adresáře s nimi (výchozí je adresář
+ * journalu pluginu). Soubory se čtou v pořadí jmen, tj. chronologicky.
+ * Filtry: podřetězec jména komponenty, minimální severity a časový rozsah
+ * (lokální čas "YYYY-MM-DD[ HH:MM[:SS]]" nebo ISO 8601). Souhrn (počty
+ * záznamů a ztracených záznamů) jde na stderr.
+ *
+ * Použití: IthacaLogDecoder [soubor|adresar ...] [--format text|csv]
+ *                           [--component <text>] [--severity <debug|info|warn|error>]
+ *                           [--from <cas>] [--to <cas>] [--output <soubor>]
+ */
+namespace
+{
+    const char* const valueOptions[] = { "--format", "--component", "--severity", "--from", "--to", "--output" };
+
+    bool isValueOption (const juce::String& argument)
+    {
+        for (auto* option : valueOptions)
+            if (argument == option)
+                return true;
+
+        return false;
+    }
+
+    int getSeverityRank (const juce::String& severity)
+    {
+        if (severity.equalsIgnoreCase ("debug")) return 0;
+        if (severity.equalsIgnoreCase ("warn"))  return 2;
+        if (severity.equalsIgnoreCase ("error")) return 3;
+        return 1;
+    }
+
+    /**
+     * Lokální čas "YYYY-MM-DD", "YYYY-MM-DD HH:MM" nebo "YYYY-MM-DD HH:MM:SS";
+     * s 'T' se text bere jako ISO 8601.
+     */
+    bool parseTime (const juce::String& text, juce::int64& timeMs)
+    {
+        if (text.containsChar ('T'))
+        {
+            timeMs = juce::Time::fromISO8601 (text).toMilliseconds();
+            return timeMs != 0;
+        }
+
+        juce::StringArray parts;
+        parts.addTokens (text.trim(), "- :", "");
+        parts.removeEmptyStrings();
+
+        if (parts.size() != 3 && parts.size() != 5 && parts.size() != 6)
+            return false;
+
+        int values[6] = { 0, 1, 1, 0, 0, 0 };
+        for (int i = 0; i < parts.size(); ++i)
+        {
+            if (! parts[i].containsOnly ("0123456789"))
+                return false;
+
+            values[i] = parts[i].getIntValue();
+        }
+
+        timeMs = juce::Time (values[0], values[1] - 1, values[2], values[3], values[4], values[5], 0, true).toMilliseconds();
+        return true;
+    }
+
+    juce::String formatTime (juce::int64 timeMs)
+    {
+        return juce::Time (timeMs).formatted ("%Y-%m-%d %H:%M:%S") + "." + juce::String (timeMs % 1000).paddedLeft ('0', 3);
+    }
+
+    juce::String csvField (const juce::String& text)
+    {
+        if (! text.containsAnyOf (",\"\r\n"))
+            return text;
+
+        return "\"" + text.replace ("\"", "\"\"") + "\"";
+    }
+
+    struct Filter
+    {
+        juce::String component;
+        int minSeverity = 0;
+        juce::int64 fromMs = std::numeric_limits<juce::int64>::min();
+        juce::int64 toMs = std::numeric_limits<juce::int64>::max();
+
+        bool matches (const LogJournal::Record& record, const LogEntry& entry) const
+        {
+            return record.timeMs >= fromMs
+                && record.timeMs <= toMs
+                && getSeverityRank (entry.severity) >= minSeverity
+                && (component.isEmpty() || entry.component.containsIgnoreCase (component));
+        }
+    };
+}
+
+int main (int argc, char* argv[])
+{
+    juce::ArgumentList args (argc, argv);
+
+    const auto format = args.containsOption ("--format") ? args.getValueForOption ("--format").toLowerCase() : juce::String ("text");
+    if (format != "text" && format != "csv")
+    {
+        std::cerr << "Neznamy format: " << format << " (text|csv)" << std::endl;
+        return 1;
+    }
+
+    Filter filter;
+    filter.component = args.getValueForOption ("--component");
+
+    if (args.containsOption ("--severity"))
+        filter.minSeverity = getSeverityRank (args.getValueForOption ("--severity"));
+
+    if (args.containsOption ("--from") && ! parseTime (args.getValueForOption ("--from"), filter.fromMs))
+    {
+        std::cerr << "Neplatny cas --from: " << args.getValueForOption ("--from") << std::endl;
+        return 1;
+    }
+
+    if (args.containsOption ("--to") && ! parseTime (args.getValueForOption ("--to"), filter.toMs))
+    {
+        std::cerr << "Neplatny cas --to: " << args.getValueForOption ("--to") << std::endl;
+        return 1;
+    }
+
+    // Vstupy: volné argumenty (soubory i adresáře), jinak adresář journalu pluginu
+    juce::Array<juce::File> files;
+    for (int i = 0; i < args.size(); ++i)
+    {
+        const auto& argument = args.arguments.getReference (i);
+
+        if (argument.isOption())
+        {
+            if (isValueOption (argument.text))
+                ++i;
+
+            continue;
+        }
+
+        const auto input = argument.resolveAsFile();
+        if (input.isDirectory())
+        {
+            for (const auto& file : LogJournal::findJournalFiles (input))
+                files.add (file);
+        }
+        else
+        {
+            files.add (input);
+        }
+    }
+
+    if (files.isEmpty())
+        files = LogJournal::findJournalFiles (IthacaConfig::getLogJournalDirectory());
+
+    if (files.isEmpty())
+    {
+        std::cerr << "Zadne soubory journalu" << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<juce::FileOutputStream> fileOutput;
+    if (args.containsOption ("--output"))
+    {
+        fileOutput = std::make_unique<juce::FileOutputStream> (args.getFileForOption ("--output"));
+        if (! fileOutput->openedOk() || fileOutput->truncate().failed())
+        {
+            std::cerr << "Vystupni soubor nelze otevrit: " << args.getFileForOption ("--output").getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    auto emit = [&fileOutput] (const juce::String& line)
+    {
+        if (fileOutput != nullptr)
+            fileOutput->writeText (line + "\n", false, false, nullptr);
+        else
+            std::cout << line << '\n';
+    };
+
+    if (format == "csv")
+        emit ("sequence,time,component,severity,message");
+
+    juce::uint64 numRecords = 0, numWritten = 0, numLost = 0;
+    int numFailed = 0;
+    std::vector<LogJournal::Record> records;
+
+    for (const auto& file : files)
+    {
+        LogJournal::FileHeader header;
+        juce::String error;
+
+        records.clear();
+        if (! LogJournal::readFile (file, header, records, error))
+        {
+            std::cerr << file.getFullPathName() << ": " << error << std::endl;
+            ++numFailed;
+            continue;
+        }
+
+        numRecords += records.size();
+        numLost += header.lostEntries;
+
+        for (const auto& record : records)
+        {
+            const auto entry = record.toEntry();
+            if (! filter.matches (record, entry))
+                continue;
+
+            if (format == "csv")
+                emit (juce::String (entry.sequence) + "," + formatTime (entry.timeMs) + "," + csvField (entry.component)
+                      + "," + csvField (entry.severity) + "," + csvField (entry.message));
+            else
+                emit (entry.toString());
+
+            ++numWritten;
+        }
+    }
+
+    if (fileOutput != nullptr)
+        fileOutput->flush();
+    else
+        std::cout.flush();
+
+    std::cerr << "Soubory: " << files.size() << ", zaznamy: " << numRecords << ", vypsano: " << numWritten
+              << ", ztraceno pri zapisu: " << numLost << std::endl;
+
+    return numFailed == 0 ? 0 : 1;
+}
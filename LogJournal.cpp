@@ -0,0 +1,315 @@
+#include "LogJournal.h"
+#include "IthacaConfig.h"
+#include "Logger.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+LogEntry LogJournal::Record::toEntry() const
+{
+    LogEntry entry;
+    entry.sequence = sequence;
+    entry.timeMs = timeMs;
+    entry.severity = juce::String::fromUTF8 (severity, (int) strnlen (severity, sizeof (severity)));
+    entry.component = juce::String::fromUTF8 (component, (int) strnlen (component, sizeof (component)));
+    entry.message = juce::String::fromUTF8 (message, (int) strnlen (message, sizeof (message)));
+    return entry;
+}
+
+//==============================================================================
+LogJournal::LogJournal()
+    : LogJournal (IthacaConfig::getLogJournalDirectory())
+{
+}
+
+LogJournal::LogJournal (const juce::File& journalDirectory, int numRecordsPerFile, int maxNumFiles)
+    : directory (journalDirectory),
+      recordsPerFile (juce::jmax (1, numRecordsPerFile)),
+      maxFiles (juce::jmax (1, maxNumFiles))
+{
+    sessionStartMs = juce::Time::currentTimeMillis();
+    sessionName = "journal-" + juce::Time (sessionStartMs).formatted ("%Y%m%d-%H%M%S")
+                + "-" + juce::String (sessionStartMs % 1000).paddedLeft ('0', 3);
+}
+
+LogJournal::~LogJournal()
+{
+    stop();
+    closeFile();
+}
+
+void LogJournal::start()
+{
+    if (! thread.isThreadRunning())
+        thread.startThread (juce::Thread::Priority::background);
+}
+
+void LogJournal::stop()
+{
+    thread.stopThread (2000);
+
+    // Dopsání záznamů od posledního průchodu vlákna
+    pump();
+}
+
+void LogJournal::addWriter()
+{
+    const juce::ScopedLock sl (writersLock);
+
+    if (numWriters++ > 0)
+        return;
+
+    // Po vypnutí se pokračuje od aktuálního záznamu - vynechané nejsou ztracené
+    {
+        const juce::ScopedLock pl (pumpLock);
+        if (nextSequence > 0)
+            nextSequence = Logger::getInstance().getTotalEntries();
+    }
+
+    start();
+}
+
+void LogJournal::removeWriter()
+{
+    const juce::ScopedLock sl (writersLock);
+    jassert (numWriters > 0);
+
+    if (numWriters > 0 && --numWriters == 0)
+    {
+        // Vypnutý journal nedrží namapovaný soubor; další zápis otevře nový
+        stop();
+
+        const juce::ScopedLock pl (pumpLock);
+        closeFile();
+    }
+}
+
+/**
+ * Přenos záznamů, které v Loggeru přibyly od posledního průchodu.
+ * Soubor se vytváří až s prvním záznamem, takže nevyužitý journal nic nezapíše.
+ */
+void LogJournal::pump()
+{
+    const juce::ScopedLock sl (pumpLock);
+
+    // Značka živosti i bez nových záznamů - jiný proces podle ní soubor nemaže
+    if (mappedFile != nullptr)
+        header().lastActiveMs = juce::Time::currentTimeMillis();
+
+    auto& logger = Logger::getInstance();
+    if (failed || logger.getTotalEntries() == nextSequence)
+        return;
+
+    pending.clear();
+    const auto next = logger.readEntries (nextSequence, pending);
+
+    for (const auto& entry : pending)
+        append (entry);
+
+    nextSequence = next;
+}
+
+void LogJournal::append (const LogEntry& entry)
+{
+    if (mappedFile == nullptr || header().numRecords >= header().capacity)
+        if (! openNextFile())
+            return;
+
+    auto& fileHeader = header();
+
+    // Mezera v pořadí = záznamy přepsané v Loggeru (záznamy před spuštěním journalu se nepočítají)
+    if (entry.sequence > nextSequence && nextSequence > 0)
+        fileHeader.lostEntries += entry.sequence - nextSequence;
+
+    nextSequence = entry.sequence + 1;
+
+    auto& record = records[fileHeader.numRecords];
+    record.sequence = entry.sequence;
+    record.timeMs = entry.timeMs;
+    entry.severity.copyToUTF8 (record.severity, sizeof (record.severity));
+    entry.component.copyToUTF8 (record.component, sizeof (record.component));
+    entry.message.copyToUTF8 (record.message, sizeof (record.message));
+
+    // Počet se zvýší až po zápisu záznamu - čtenář živého souboru nevidí rozepsaný záznam
+    std::atomic_thread_fence (std::memory_order_release);
+    fileHeader.numRecords = fileHeader.numRecords + 1;
+}
+
+bool LogJournal::openNextFile()
+{
+    closeFile();
+
+    const auto result = directory.createDirectory();
+    if (result.failed())
+    {
+        failed = true;
+        ITHACA_LOG_ERROR ("LogJournal/openNextFile",
+                          "Adresar journalu nelze vytvorit: " + directory.getFullPathName() + " (" + result.getErrorMessage() + ")");
+        return false;
+    }
+
+    removeOldFiles();
+
+    const auto file = directory.getChildFile (sessionName + "-" + juce::String (nextFileIndex).paddedLeft ('0', 4) + fileExtension);
+    const auto recordBytes = sizeof (Record) * (size_t) recordsPerFile;
+
+    FileHeader initialHeader;
+    initialHeader.magic = magic;
+    initialHeader.version = formatVersion;
+    initialHeader.recordSize = (juce::uint32) sizeof (Record);
+    initialHeader.capacity = (juce::uint32) recordsPerFile;
+    initialHeader.fileIndex = nextFileIndex++;
+    initialHeader.sessionStartMs = sessionStartMs;
+    initialHeader.lastActiveMs = juce::Time::currentTimeMillis();
+
+    // Předalokace celého souboru - mapování má pevnou velikost
+    {
+        juce::FileOutputStream out (file);
+        const bool written = out.openedOk()
+                          && out.setPosition (0)
+                          && out.truncate().wasOk()
+                          && out.write (&initialHeader, sizeof (initialHeader))
+                          && out.writeRepeatedByte (0, recordBytes);
+        out.flush();
+
+        if (! written || out.getStatus().failed())
+        {
+            failed = true;
+            ITHACA_LOG_ERROR ("LogJournal/openNextFile", "Soubor journalu nelze vytvorit: " + file.getFullPathName());
+            return false;
+        }
+    }
+
+    mappedFile = std::make_unique<juce::MemoryMappedFile> (file, juce::MemoryMappedFile::readWrite);
+
+    if (mappedFile->getData() == nullptr || mappedFile->getSize() < sizeof (FileHeader) + recordBytes)
+    {
+        mappedFile.reset();
+        failed = true;
+        ITHACA_LOG_ERROR ("LogJournal/openNextFile", "Soubor journalu nelze namapovat: " + file.getFullPathName());
+        return false;
+    }
+
+    records = reinterpret_cast<Record*> (static_cast<char*> (mappedFile->getData()) + sizeof (FileHeader));
+    return true;
+}
+
+void LogJournal::closeFile()
+{
+    records = nullptr;
+    mappedFile.reset();
+}
+
+/**
+ * Uvolnění místa pro nový soubor, aby v adresáři bylo nejvýš maxFiles souborů.
+ * Mažou se od nejstaršího soubory vlastní relace a relací, které déle než
+ * liveSessionTimeoutMs nezapsaly (ukončené nebo spadlé procesy). Adresář je
+ * společný všem procesům hostitele; soubor relace, která ještě může zapisovat,
+ * se přeskočí.
+ */
+void LogJournal::removeOldFiles()
+{
+    const auto files = findJournalFiles (directory);
+    const auto ownPrefix = sessionName + "-";
+    const auto now = juce::Time::currentTimeMillis();
+
+    for (int i = 0, excess = files.size() - maxFiles + 1; i < files.size() && excess > 0; ++i)
+    {
+        const auto& file = files.getReference (i);
+
+        if (! file.getFileName().startsWith (ownPrefix) && now - getLastActiveMs (file) < liveSessionTimeoutMs)
+            continue;
+
+        if (file.deleteFile())
+            --excess;
+    }
+}
+
+/**
+ * Poslední zápis do souboru: značka v hlavičce (mmap zápisy nemusí měnit čas
+ * souboru), nebo čas změny souboru, pokud je novější / hlavička nejde přečíst.
+ */
+juce::int64 LogJournal::getLastActiveMs (const juce::File& file)
+{
+    auto lastActive = file.getLastModificationTime().toMilliseconds();
+
+    juce::FileInputStream in (file);
+    FileHeader fileHeader;
+
+    if (in.openedOk() && in.read (&fileHeader, (int) sizeof (fileHeader)) == (int) sizeof (fileHeader)
+        && fileHeader.magic == magic)
+        lastActive = juce::jmax (lastActive, fileHeader.lastActiveMs);
+
+    return lastActive;
+}
+
+LogJournal::FileHeader& LogJournal::header() const noexcept
+{
+    return *static_cast<FileHeader*> (mappedFile->getData());
+}
+
+//==============================================================================
+juce::Array<juce::File> LogJournal::findJournalFiles (const juce::File& journalDirectory)
+{
+    auto files = journalDirectory.findChildFiles (juce::File::findFiles, false, juce::String ("*") + fileExtension);
+
+    // Jméno začíná časem startu relace a pořadím souboru
+    std::sort (files.begin(), files.end(), [] (const juce::File& a, const juce::File& b)
+    {
+        return a.getFileName() < b.getFileName();
+    });
+
+    return files;
+}
+
+bool LogJournal::readFile (const juce::File& file, FileHeader& fileHeader, std::vector<Record>& destination,
+                           juce::String& errorMessage)
+{
+    juce::FileInputStream in (file);
+    if (! in.openedOk())
+    {
+        errorMessage = "Soubor nelze otevrit";
+        return false;
+    }
+
+    if (in.read (&fileHeader, (int) sizeof (fileHeader)) != (int) sizeof (fileHeader)
+        || fileHeader.magic != magic)
+    {
+        errorMessage = "Neni to soubor journalu";
+        return false;
+    }
+
+    if (fileHeader.version != formatVersion || fileHeader.recordSize != sizeof (Record))
+    {
+        errorMessage = "Nepodporovana verze journalu: " + juce::String (fileHeader.version);
+        return false;
+    }
+
+    // Soubor mohl zůstat po pádu nebo se ještě zapisuje - čte se jen to, co v něm skutečně je
+    const auto available = (juce::uint64) juce::jmax ((juce::int64) 0, in.getTotalLength() - (juce::int64) sizeof (FileHeader))
+                         / sizeof (Record);
+    const auto numRecords = (size_t) juce::jmin (fileHeader.numRecords, (juce::uint64) fileHeader.capacity, available);
+
+    const auto firstNew = destination.size();
+    destination.resize (firstNew + numRecords);
+
+    const auto bytes = (int) (numRecords * sizeof (Record));
+    if (in.read (destination.data() + firstNew, bytes) != bytes)
+    {
+        destination.resize (firstNew);
+        errorMessage = "Soubor journalu je zkraceny";
+        return false;
+    }
+
+    return true;
+}
+
+//==============================================================================
+void LogJournal::JournalThread::run()
+{
+    while (! threadShouldExit())
+    {
+        owner.pump();
+        wait (pollIntervalMs);
+    }
+}
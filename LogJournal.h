@@ -0,0 +1,136 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "LogStore.h"
+
+/**
+ * Třída LogJournal - volitelný souborový sink logu (celá relace na disk).
+ * Zapisuje jen tehdy, když ho některá instance pluginu zapne (addWriter).
+ *
+ * Vlákno na pozadí si z Loggeru vyzvedává nové záznamy po pořadových číslech
+ * (stejně jako LogView) a kopíruje je do memory-mapped souboru s pevně
+ * velkými binárními záznamy. Zapisovatelé logu o journalu nevědí - jejich
+ * cena se nemění, formátování ani souborové I/O na ně nečeká. Zápis do
+ * namapované paměti je obyčejné memcpy; stránky na disk propisuje OS,
+ * takže záznamy přežijí i pád hostitele.
+ *
+ * Soubor má hlavičku a místo pro recordsPerFile záznamů; po zaplnění se
+ * otevře další. Z adresáře se mažou nejstarší soubory *.ithj nad maxFiles,
+ * takže místo na disku je omezené - ale jen vlastní relace a relací, které
+ * už nezapisují (lastActiveMs v hlavičce). Journal jiného běžícího procesu
+ * se nemaže, ani když limit překročí. Pokud Logger přepíše záznamy dřív, než
+ * je journal vyzvedne, počet ztracených se uloží do hlavičky (lostEntries)
+ * a v posloupnosti sequence zůstane mezera.
+ *
+ * Formát je nativní little-endian; čte ho readFile() (viz IthacaLogDecoder).
+ */
+class LogJournal
+{
+public:
+    static constexpr juce::uint32 magic = 0x4A485449;   // "ITHJ"
+    static constexpr juce::uint32 formatVersion = 1;
+    static constexpr int defaultRecordsPerFile = 16384;  // ~5 MB na soubor
+    static constexpr int defaultMaxFiles = 8;
+    static constexpr int pollIntervalMs = 50;
+    static constexpr int liveSessionTimeoutMs = 60000;  // Cizí relace bez zápisu déle = ukončená
+    static constexpr const char* fileExtension = ".ithj";
+
+    struct FileHeader
+    {
+        juce::uint32 magic = 0;
+        juce::uint32 version = 0;
+        juce::uint32 recordSize = 0;
+        juce::uint32 capacity = 0;          // Místo pro záznamy v tomto souboru
+        juce::uint32 fileIndex = 0;         // Pořadí souboru v rámci relace
+        juce::uint32 reserved = 0;
+        juce::int64 sessionStartMs = 0;
+        juce::uint64 numRecords = 0;        // Dokončené záznamy (zapisuje se až po nich)
+        juce::uint64 lostEntries = 0;       // Přepsané v Loggeru dřív, než je journal vyzvedl
+        juce::int64 lastActiveMs = 0;       // Poslední průchod zapisujícího vlákna (živost relace pro mazání)
+        juce::uint8 padding[8] = {};
+    };
+
+    struct Record
+    {
+        juce::uint64 sequence = 0;
+        juce::int64 timeMs = 0;
+        char severity[LogStore::maxSeverityBytes] = {};
+        char component[LogStore::maxComponentBytes] = {};
+        char message[LogStore::maxMessageBytes] = {};
+
+        LogEntry toEntry() const;
+    };
+
+    static_assert (sizeof (FileHeader) == 64, "Hlavicka journalu musi mit 64 bajtu");
+    static_assert (sizeof (Record) % 8 == 0, "Zaznam journalu musi byt zarovnany na 8 bajtu");
+
+    LogJournal();
+    explicit LogJournal (const juce::File& directory,
+                         int recordsPerFile = defaultRecordsPerFile,
+                         int maxFiles = defaultMaxFiles);
+    ~LogJournal();
+
+    // Spuštění/zastavení vlákna (mimo audio vlákno); stop() dopíše čekající záznamy
+    void start();
+    void stop();
+    bool isRunning() const { return thread.isThreadRunning(); }
+
+    // Instance pluginu, které zápis chtějí (SamplerSettings::writeLogJournal):
+    // první spustí vlákno, poslední ho zastaví
+    void addWriter();
+    void removeWriter();
+
+    const juce::File& getDirectory() const noexcept { return directory; }
+
+    // Soubory journalu v adresáři seřazené od nejstaršího
+    static juce::Array<juce::File> findJournalFiles (const juce::File& directory);
+
+    // Načtení hlavičky a dokončených záznamů; při chybě vrací false a popis v errorMessage
+    static bool readFile (const juce::File& file, FileHeader& header, std::vector<Record>& records,
+                          juce::String& errorMessage);
+
+private:
+    class JournalThread : public juce::Thread
+    {
+    public:
+        explicit JournalThread (LogJournal& o) : juce::Thread ("IthacaPlayer LogJournal"), owner (o) {}
+        void run() override;
+
+    private:
+        LogJournal& owner;
+    };
+
+    // Přenos nových záznamů z Loggeru do souboru (jen vlákno journalu / stop)
+    void pump();
+    void append (const LogEntry& entry);
+    bool openNextFile();
+    void closeFile();
+    void removeOldFiles();
+    static juce::int64 getLastActiveMs (const juce::File& file);
+    FileHeader& header() const noexcept;
+
+    const juce::File directory;
+    const int recordsPerFile;
+    const int maxFiles;
+
+    juce::int64 sessionStartMs = 0;
+    juce::String sessionName;
+    juce::uint32 nextFileIndex = 0;
+
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    Record* records = nullptr;
+    juce::uint64 nextSequence = 0;
+    bool failed = false;                    // Soubor nejde vytvořit - další pokusy se nedělají
+    std::vector<LogEntry> pending;
+
+    juce::CriticalSection pumpLock;
+    JournalThread thread { *this };
+
+    juce::CriticalSection writersLock;
+    int numWriters = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (LogJournal)
+};
@@ -0,0 +1,106 @@
+#include "LogStore.h"
+#include <cstring>
+
+juce::String LogEntry::toString() const
+{
+    return "[" + juce::Time (timeMs).formatted ("%Y-%m-%d %H:%M:%S") + "] [" + component + "] [" + severity + "]: " + message;
+}
+
+LogStore::LogStore (int capacity)
+{
+    setCapacity (capacity);
+}
+
+LogStore::~LogStore() = default;
+
+void LogStore::copyText (char* destination, int maxBytes, const juce::String& text) noexcept
+{
+    // Ořez na hranici znaku UTF-8, vždy ukončeno nulou
+    text.copyToUTF8 (destination, (size_t) maxBytes);
+}
+
+void LogStore::write (const juce::String& component, const juce::String& severity, const juce::String& message) noexcept
+{
+    // Pořadí se přidělí dřív, než se načte úložiště (viz setCapacity)
+    const auto sequence = nextSequence.fetch_add (1);
+    auto* storage = current.load();
+
+    auto& slot = storage->slots[(size_t) (sequence % (juce::uint64) storage->capacity)];
+    slot.state.store (2 * sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_release);
+
+    slot.timeMs = juce::Time::currentTimeMillis();
+    copyText (slot.component, maxComponentBytes, component);
+    copyText (slot.severity, maxSeverityBytes, severity);
+    copyText (slot.message, maxMessageBytes, message);
+
+    slot.state.store (2 * sequence + 2, std::memory_order_release);
+}
+
+juce::uint64 LogStore::read (juce::uint64 fromSequence, std::vector<LogEntry>& destination, int maxEntries) const
+{
+    const auto* storage = current.load (std::memory_order_acquire);
+    const auto end = nextSequence.load (std::memory_order_acquire);
+    const auto capacity = (juce::uint64) storage->capacity;
+
+    auto begin = juce::jmax (fromSequence, storage->firstSequence.load (std::memory_order_acquire));
+    if (end > capacity)
+        begin = juce::jmax (begin, end - capacity);
+    if (maxEntries >= 0 && end > (juce::uint64) maxEntries)
+        begin = juce::jmax (begin, end - (juce::uint64) maxEntries);
+
+    Slot copy;
+
+    for (auto sequence = begin; sequence < end; ++sequence)
+    {
+        const auto& slot = storage->slots[(size_t) (sequence % capacity)];
+        const auto expected = 2 * sequence + 2;
+
+        const auto before = slot.state.load (std::memory_order_acquire);
+        if (before < expected)
+            return sequence;        // Zápis ještě probíhá - příště se naváže zde
+
+        if (before > expected)
+            continue;               // Přepsáno novějším záznamem
+
+        copy.timeMs = slot.timeMs;
+        std::memcpy (copy.component, slot.component, sizeof (copy.component));
+        std::memcpy (copy.severity, slot.severity, sizeof (copy.severity));
+        std::memcpy (copy.message, slot.message, sizeof (copy.message));
+
+        std::atomic_thread_fence (std::memory_order_acquire);
+        if (slot.state.load (std::memory_order_relaxed) != expected)
+            continue;               // Přepsáno během kopírování
+
+        LogEntry entry;
+        entry.sequence = sequence;
+        entry.timeMs = copy.timeMs;
+        entry.component = juce::String::fromUTF8 (copy.component);
+        entry.severity = juce::String::fromUTF8 (copy.severity);
+        entry.message = juce::String::fromUTF8 (copy.message);
+        destination.push_back (std::move (entry));
+    }
+
+    return juce::jmax (end, fromSequence);
+}
+
+/**
+ * Nové úložiště se zveřejní dřív, než se určí jeho první pořadí. Zapisovatel
+ * si bere pořadí před načtením úložiště (obojí seq_cst), takže každé pořadí
+ * >= firstSequence se zapíše do nového úložiště.
+ */
+void LogStore::setCapacity (int newCapacity)
+{
+    const juce::ScopedLock sl (storageLock);
+
+    storages.push_back (std::make_unique<Storage> (juce::jmax (1, newCapacity)));
+    auto* storage = storages.back().get();
+
+    current.store (storage);
+    storage->firstSequence.store (nextSequence.load());
+}
+
+int LogStore::getCapacity() const noexcept
+{
+    return current.load (std::memory_order_acquire)->capacity;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <vector>
+
+/**
+ * Záznam přečtený z LogStore (kopie pro čtenáře, vlastní stringy).
+ */
+struct LogEntry
+{
+    juce::uint64 sequence = 0;
+    juce::int64 timeMs = 0;         // juce::Time::currentTimeMillis() při zápisu
+    juce::String component;
+    juce::String severity;
+    juce::String message;
+
+    // "[YYYY-MM-DD HH:MM:SS] [komponenta] [severity]: zpráva"
+    juce::String toString() const;
+};
+
+/**
+ * Třída LogStore - kruhový úložný buffer logu s pevnou kapacitou.
+ *
+ * Sloty jsou předalokované záznamy pevné velikosti (texty se ořezávají),
+ * takže zápis nic nealokuje a nic neposouvá. Každý zápis dostane pořadové
+ * číslo z atomického čítače (wait-free i pro více zapisovatelů) a slot
+ * seq % kapacita. Slot nese stav 2 * seq + 1 během zápisu a 2 * seq + 2 po
+ * jeho dokončení; čtenář záznam přijme, jen když stav před i po kopii
+ * odpovídá dokončenému zápisu stejného pořadí (jinak ho mezitím přepsal novější).
+ * Rozpracovaný zápis čtení zastaví - čtenář na něj příště naváže, takže
+ * žádný záznam nepřeskočí. Data jsou konzistentní, pokud zapisovatelé
+ * nepředběhnou jeden druhého o celou kapacitu během jediného zápisu.
+ *
+ * Čtenáři berou snímek po rozsahu pořadových čísel (read) a nikdy neblokují
+ * zapisovatele. Kapacitu lze změnit za běhu: nové sloty se atomicky
+ * zveřejní a staré zůstanou platné do zániku úložiště, takže souběžný
+ * zápis do nich je bezpečný (jen se už nezobrazí).
+ */
+class LogStore
+{
+public:
+    static constexpr int defaultCapacity = 1000;
+    static constexpr int maxComponentBytes = 64;
+    static constexpr int maxSeverityBytes = 8;
+    static constexpr int maxMessageBytes = 240;
+
+    explicit LogStore (int capacity = defaultCapacity);
+    ~LogStore();
+
+    // Zápis záznamu (libovolné vlákno, wait-free, bez alokací)
+    void write (const juce::String& component, const juce::String& severity, const juce::String& message) noexcept;
+
+    // Pořadové číslo, které dostane příští zápis (= počet všech zápisů)
+    juce::uint64 getNextSequence() const noexcept { return nextSequence.load (std::memory_order_acquire); }
+
+    /**
+     * Záznamy s pořadím >= fromSequence, které jsou ještě v bufferu, seřazené
+     * podle pořadí (nejvýš maxEntries nejnovějších). Vrací pořadí, od kterého
+     * má čtenář pokračovat příště.
+     */
+    juce::uint64 read (juce::uint64 fromSequence, std::vector<LogEntry>& destination, int maxEntries = -1) const;
+
+    // Změna kapacity za běhu (mimo audio vlákno); dosavadní záznamy se nepřenášejí
+    void setCapacity (int newCapacity);
+    int getCapacity() const noexcept;
+
+private:
+    struct Slot
+    {
+        std::atomic<juce::uint64> state { 0 };
+        juce::int64 timeMs = 0;
+        char component[maxComponentBytes] = {};
+        char severity[maxSeverityBytes] = {};
+        char message[maxMessageBytes] = {};
+    };
+
+    struct Storage
+    {
+        explicit Storage (int numSlots) : capacity (numSlots), slots (new Slot[(size_t) numSlots]) {}
+
+        const int capacity;
+        std::unique_ptr<Slot[]> slots;
+        std::atomic<juce::uint64> firstSequence { std::numeric_limits<juce::uint64>::max() };  // První pořadí zapsané sem
+    };
+
+    static void copyText (char* destination, int maxBytes, const juce::String& text) noexcept;
+
+    std::atomic<Storage*> current { nullptr };
+    std::atomic<juce::uint64> nextSequence { 0 };
+
+    // Všechna kdy zveřejněná úložiště (zapisovatel může ještě držet starší)
+    juce::CriticalSection storageLock;
+    std::vector<std::unique_ptr<Storage>> storages;
+
+    JUCE_DECLARE_NON_COPYABLE (LogStore)
+};
@@ -0,0 +1,128 @@
+#include "LogView.h"
+#include "Logger.h"
+
+LogView::LogView (int capacity)
+    : listBox ("LogView", this),
+      font (juce::FontOptions (juce::Font::getDefaultMonospacedFontName(), 11.0f, juce::Font::plain)),
+      rows ((size_t) juce::jmax (1, capacity))
+{
+    listBox.setRowHeight (14);
+    listBox.setOutlineThickness (1);
+    listBox.setColour (juce::ListBox::backgroundColourId, juce::Colour (0xff1e1e1e));    // Tmavě šedé pozadí
+    listBox.setColour (juce::ListBox::outlineColourId, juce::Colour (0xff404040));       // Tmavý okraj
+    addAndMakeVisible (listBox);
+
+    // Nejvýš jedno převzetí a překreslení za snímek
+    startTimerHz (30);
+}
+
+LogView::~LogView()
+{
+    stopTimer();
+}
+
+void LogView::clear()
+{
+    firstRow = 0;
+    numRows = 0;
+    listBox.updateContent();
+    listBox.repaint();
+}
+
+void LogView::setFont (const juce::Font& newFont)
+{
+    font = newFont;
+    listBox.setRowHeight (juce::roundToInt (font.getHeight()) + 3);
+}
+
+void LogView::resized()
+{
+    listBox.setBounds (getLocalBounds());
+}
+
+void LogView::timerCallback()
+{
+    pullNewEntries();
+}
+
+/**
+ * Převzetí záznamů přidaných od posledního volání. Překreslí se jednou
+ * bez ohledu na počet nových řádků.
+ */
+void LogView::pullNewEntries()
+{
+    auto& logger = Logger::getInstance();
+    if (logger.getTotalEntries() == nextEntry)
+        return;
+
+    pending.clear();
+    nextEntry = logger.readEntries (nextEntry, pending, (int) rows.size());
+    if (pending.empty())
+        return;
+
+    const bool followEnd = isScrolledToEnd();
+
+    for (const auto& entry : pending)
+        append (entry.toString());
+
+    listBox.updateContent();
+
+    if (followEnd && numRows > 0)
+        listBox.scrollToEnsureRowIsOnscreen (numRows - 1);
+
+    listBox.repaint();
+}
+
+void LogView::append (const juce::String& line)
+{
+    const int capacity = (int) rows.size();
+
+    if (numRows < capacity)
+    {
+        rows[(size_t) ((firstRow + numRows) % capacity)] = line;
+        ++numRows;
+    }
+    else
+    {
+        // Plný buffer - nejstarší řádek se přepíše
+        rows[(size_t) firstRow] = line;
+        firstRow = (firstRow + 1) % capacity;
+    }
+}
+
+const juce::String& LogView::getRow (int rowNumber) const noexcept
+{
+    return rows[(size_t) ((firstRow + rowNumber) % (int) rows.size())];
+}
+
+bool LogView::isScrolledToEnd() const
+{
+    const auto* viewport = listBox.getViewport();
+    if (viewport == nullptr)
+        return true;
+
+    const int contentHeight = numRows * listBox.getRowHeight();
+    return viewport->getViewPositionY() + viewport->getViewHeight() >= contentHeight - listBox.getRowHeight();
+}
+
+void LogView::paintListBoxItem (int rowNumber, juce::Graphics& g, int width, int height, bool rowIsSelected)
+{
+    if (rowNumber < 0 || rowNumber >= numRows)
+        return;
+
+    if (rowIsSelected)
+        g.fillAll (juce::Colour (0xff303a30));
+
+    const auto& line = getRow (rowNumber);
+
+    // Zelený text (matrix style), chyby a varování zvýrazněné
+    auto colour = juce::Colour (0xff00ff00);
+    if (line.contains ("] [error]"))
+        colour = juce::Colour (0xffff5050);
+    else if (line.contains ("] [warn]"))
+        colour = juce::Colour (0xffffb040);
+
+    g.setColour (colour);
+    g.setFont (font);
+    g.drawText (line, 4, 0, width - 8, height, juce::Justification::centredLeft, false);
+}
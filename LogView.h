@@ -0,0 +1,56 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <vector>
+#include "LogStore.h"
+
+/**
+ * Třída LogView - virtualizovaný výpis logu pro editor.
+ *
+ * Řádky drží vlastní kruhový buffer s pevnou kapacitou a juce::ListBox kreslí
+ * jen řádky, které jsou právě vidět, takže cena překreslení nezávisí na
+ * délce historie. Logger nikoho neupozorňuje; timer (30x za sekundu) porovná
+ * jeho pořadové číslo s posledním převzatým, převezme všechny nové řádky
+ * najednou a vyvolá jedno překreslení. Provoz na message threadu je tak
+ * stálý bez ohledu na rychlost logování.
+ *
+ * Auto-scroll: pokud je výpis odscrollovaný na konec, drží se na konci
+ * i po přidání řádků; když uživatel odscrolluje výš, pozice se nemění.
+ */
+class LogView : public juce::Component,
+                private juce::ListBoxModel,
+                private juce::Timer
+{
+public:
+    explicit LogView (int capacity = 5000);
+    ~LogView() override;
+
+    // Smazání zobrazené historie (záznamy v Loggeru zůstanou)
+    void clear();
+
+    void setFont (const juce::Font& newFont);
+
+    void resized() override;
+
+private:
+    int getNumRows() override { return numRows; }
+    void paintListBoxItem (int rowNumber, juce::Graphics& g, int width, int height, bool rowIsSelected) override;
+    void timerCallback() override;
+
+    void pullNewEntries();
+    void append (const juce::String& line);
+    const juce::String& getRow (int rowNumber) const noexcept;
+    bool isScrolledToEnd() const;
+
+    juce::ListBox listBox;
+    juce::Font font;
+
+    std::vector<juce::String> rows;     // Kruhový buffer, nejstarší řádek na firstRow
+    int firstRow = 0;
+    int numRows = 0;
+
+    juce::uint64 nextEntry = 0;         // Pořadí dalšího záznamu Loggeru k převzetí
+    std::vector<LogEntry> pending;      // Znovupoužívaný buffer pro snímek z Loggeru
+
+    JUCE_DECLARE_NON_COPYABLE (LogView)
+};
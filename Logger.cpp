@@ -1,8 +1,8 @@
 #include "Logger.h"
-#include "PluginEditor.h"
 
-// Inicializace statické proměnné
-bool Logger::loggingEnabled = true;
+// Inicializace statických proměnných
+std::atomic<bool> Logger::loggingEnabled { true };
+std::atomic<LogSeverity> Logger::minimumSeverity { LogSeverity::Debug };
 
 /**
  * Získání instance singletonu.
@@ -14,46 +14,23 @@ Logger& Logger::getInstance()
 }
 
 /**
- * Metoda pro logování s thread-safety pro GUI aktualizace.
+ * Metoda pro logování. Editor se o novém záznamu dozví z getTotalEntries().
  */
-void Logger::log(const juce::String& component, const juce::String& severity, const juce::String& message)
+void Logger::log(const juce::String& component, LogSeverity severity, const juce::String& message)
 {
-    if (!loggingEnabled) return;
-
-    // Vytvoření timestampu
-    juce::String timestamp = juce::Time::getCurrentTime().formatted("%Y-%m-%d %H:%M:%S");
-
-    // Formátovaný log
-    juce::String logEntry = "[" + timestamp + "] [" + component + "] [" + severity + "]: " + message;
-
-    // Přidání do bufferu
-    logBuffer.add(logEntry);
+    // Timestamp a formátování až při čtení (LogEntry::toString)
+    store.write(component, getSeverityName(severity), message);
+}
 
-    // Omezení velikosti (sliding window)
-    if (logBuffer.size() > MAX_LOG_ENTRIES)
+const char* Logger::getSeverityName(LogSeverity severity) noexcept
+{
+    switch (severity)
     {
-        logBuffer.removeRange(0, 1);
+        case LogSeverity::Debug: return "debug";
+        case LogSeverity::Info:  return "info";
+        case LogSeverity::Warn:  return "warn";
+        case LogSeverity::Error: return "error";
     }
 
-    // Thread-safe aktualizace GUI
-    auto currentEditor = editor.load();
-    if (currentEditor != nullptr)
-    {
-        // Použití MessageManager pro bezpečnou aktualizaci GUI z libovolného vlákna
-        juce::MessageManager::callAsync([this, currentEditor]() {
-            // Dvojitá kontrola po async volání
-            if (editor.load() == currentEditor && currentEditor != nullptr)
-            {
-                currentEditor->updateLogDisplay();
-            }
-        });
-    }
+    return "info";
 }
-
-/**
- * Thread-safe nastavení reference na editor.
- */
-void Logger::setEditor(AudioPluginAudioProcessorEditor* ed)
-{
-    editor.store(ed);
-}
\ No newline at end of file
@@ -4,20 +4,48 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_events/juce_events.h>
 #include <atomic>
+#include <cstdint>
+#include <vector>
+#include "LogStore.h"
 
-// Definice maximálního počtu logovacích záznamů (sliding window)
-#define MAX_LOG_ENTRIES 100
+/**
+ * Severity logovacího záznamu (vzestupně podle závažnosti).
+ */
+enum class LogSeverity : uint8_t
+{
+    Debug = 0,
+    Info,
+    Warn,
+    Error
+};
 
-// Forward declaration pro AudioPluginAudioProcessorEditor
-class AudioPluginAudioProcessorEditor;
+/**
+ * Nejnižší severity, která se vůbec zkompiluje (0 = Debug ... 3 = Error).
+ * Release build vynechá debug volání úplně; přepsat lze definicí překladače.
+ */
+#ifndef ITHACA_LOG_MIN_SEVERITY
+ #if JUCE_DEBUG
+  #define ITHACA_LOG_MIN_SEVERITY 0
+ #else
+  #define ITHACA_LOG_MIN_SEVERITY 1
+ #endif
+#endif
 
 /**
  * Třída Logger - Thread-safe Singleton pro logování událostí v pluginu.
  * 
  * Poskytuje metodu pro logování s timestampem, komponentou, severity a zprávou.
- * Ukládá logy do bufferu s omezenou velikostí (sliding window).
- * Logování lze globálně zapnout/vypnout.
- * Thread-safe aktualizace GUI pomocí MessageManager.
+ * Ukládá logy do kruhového LogStore s pevnou kapacitou (nastavitelnou za běhu);
+ * zápis je wait-free a bez alokací, čtení po rozsahu pořadových čísel.
+ * Logování lze globálně zapnout/vypnout a za běhu omezit minimální severity.
+ *
+ * Volání jdou přes makra ITHACA_LOG_DEBUG/INFO/WARN/ERROR: zpráva se sestaví
+ * až po kontrole úrovně (v době překladu ITHACA_LOG_MIN_SEVERITY, za běhu
+ * isEnabled), takže vypnuté logování nestojí formátování stringů. Debug
+ * volání pod ITHACA_LOG_MIN_SEVERITY se do binárky vůbec nedostanou.
+ * GUI se neupozorňuje po jednotlivých záznamech: log jen zvýší pořadové
+ * číslo (getTotalEntries) a editor si změny vyzvedává vlastním timerem,
+ * takže provoz na message threadu nezávisí na rychlosti logování.
  */
 class Logger
 {
@@ -25,17 +53,38 @@ public:
     // Získání instance singletonu
     static Logger& getInstance();
 
-    // Thread-safe metoda pro logování
-    void log(const juce::String& component, const juce::String& severity, const juce::String& message);
+    // Thread-safe metoda pro logování (úroveň se zde už nekontroluje - viz makra)
+    void log(const juce::String& component, LogSeverity severity, const juce::String& message);
 
     // Globální přepínač logování
-    static bool loggingEnabled;
+    static std::atomic<bool> loggingEnabled;
+
+    // Nejnižší severity, která se zaloguje (za běhu)
+    static void setMinimumSeverity(LogSeverity severity) noexcept { minimumSeverity.store(severity, std::memory_order_relaxed); }
+    static LogSeverity getMinimumSeverity() noexcept { return minimumSeverity.load(std::memory_order_relaxed); }
+
+    // Projde záznam dané severity filtrem překladu i běhu? (bezpečné i z audio vlákna)
+    static bool isEnabled(LogSeverity severity) noexcept
+    {
+        return severity >= static_cast<LogSeverity>(ITHACA_LOG_MIN_SEVERITY)
+            && severity >= minimumSeverity.load(std::memory_order_relaxed)
+            && loggingEnabled.load(std::memory_order_relaxed);
+    }
+
+    static const char* getSeverityName(LogSeverity severity) noexcept;
+
+    // Celkový počet zalogovaných záznamů (pro převzetí jen nových řádků)
+    juce::uint64 getTotalEntries() const noexcept { return store.getNextSequence(); }
 
-    // Thread-safe nastavení reference na editor
-    void setEditor(AudioPluginAudioProcessorEditor* ed);
+    // Snímek záznamů od daného pořadí; vrací pořadí pro další čtení (viz LogStore::read)
+    juce::uint64 readEntries(juce::uint64 fromSequence, std::vector<LogEntry>& destination, int maxEntries = -1) const
+    {
+        return store.read(fromSequence, destination, maxEntries);
+    }
 
-    // Getter pro přístup k bufferu logů (const reference pro bezpečný přístup)
-    const juce::StringArray& getLogBuffer() const { return logBuffer; }
+    // Počet uchovávaných záznamů
+    void setCapacity(int numEntries) { store.setCapacity(numEntries); }
+    int getCapacity() const noexcept { return store.getCapacity(); }
 
 private:
     // Privátní konstruktor pro singleton
@@ -45,9 +94,45 @@ private:
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
-    // Buffer pro logy
-    juce::StringArray logBuffer;
+    static std::atomic<LogSeverity> minimumSeverity;
+
+    // Kruhové úložiště logů
+    LogStore store;
+};
+
+/**
+ * Logovací makra. Argumenty zprávy se vyhodnotí jen tehdy, když záznam
+ * projde filtrem; pod ITHACA_LOG_MIN_SEVERITY zůstane jen mrtvá větev
+ * (kvůli kontrole typů a nevyužitým proměnným), kterou překladač vypustí.
+ */
+#define ITHACA_LOG(severity, component, message) \
+    do { \
+        if (Logger::isEnabled (severity)) \
+            Logger::getInstance().log ((component), (severity), (message)); \
+    } while (false)
+
+#define ITHACA_LOG_DISABLED(component, message) \
+    do { \
+        if (false) \
+            juce::ignoreUnused ((component), (message)); \
+    } while (false)
+
+#if ITHACA_LOG_MIN_SEVERITY <= 0
+ #define ITHACA_LOG_DEBUG(component, message) ITHACA_LOG (LogSeverity::Debug, component, message)
+#else
+ #define ITHACA_LOG_DEBUG(component, message) ITHACA_LOG_DISABLED (component, message)
+#endif
+
+#if ITHACA_LOG_MIN_SEVERITY <= 1
+ #define ITHACA_LOG_INFO(component, message) ITHACA_LOG (LogSeverity::Info, component, message)
+#else
+ #define ITHACA_LOG_INFO(component, message) ITHACA_LOG_DISABLED (component, message)
+#endif
+
+#if ITHACA_LOG_MIN_SEVERITY <= 2
+ #define ITHACA_LOG_WARN(component, message) ITHACA_LOG (LogSeverity::Warn, component, message)
+#else
+ #define ITHACA_LOG_WARN(component, message) ITHACA_LOG_DISABLED (component, message)
+#endif
 
-    // Reference na editor pro update GUI
-    std::atomic<AudioPluginAudioProcessorEditor*> editor{nullptr};
-};
\ No newline at end of file
+#define ITHACA_LOG_ERROR(component, message) ITHACA_LOG (LogSeverity::Error, component, message)
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/**
+ * Třída MidiScheduler - rozdělení bloku podle MIDI událostí (sample-accurate).
+ *
+ * Blok se rozdělí na segmenty mezi samplePosition jednotlivých událostí:
+ * nejdřív se vyrenderuje úsek před událostí, pak se událost aplikuje a
+ * render pokračuje od její pozice. Události na stejné pozici se aplikují
+ * najednou bez mezilehlého renderu.
+ *
+ * Minimální délka segmentu brání rozdrobení renderu na jednotky vzorků při
+ * husté MIDI (CC, pitch bend). Událost bližší než minSegmentSamples ke
+ * začátku rozpracovaného segmentu se aplikuje na jeho začátku, tj. posune
+ * se dříve o méně než minSegmentSamples. Na začátku bloku se nic neposouvá,
+ * takže první segment může být kratší (jinak by se čas posouval přes hranici bloku).
+ * minSegmentSamples <= 1 znamená přesné časování každé události.
+ */
+class MidiScheduler
+{
+public:
+    /**
+     * renderSegment (startSample, numSamples) a handleEvent (data, numBytes, samplePosition)
+     * se volají na audio vlákně; nic se nealokuje.
+     */
+    template <typename RenderFunction, typename EventFunction>
+    static void process (const juce::MidiBuffer& midiMessages, int numSamples, int minSegmentSamples,
+                         RenderFunction&& renderSegment, EventFunction&& handleEvent) noexcept
+    {
+        int position = 0;
+
+        for (const auto metadata : midiMessages)
+        {
+            const int eventPosition = juce::jlimit (0, numSamples, metadata.samplePosition);
+            const int segmentLength = eventPosition - position;
+
+            // Segment je dost dlouhý (nebo začíná blok) - vyrenderuje se až k události
+            if (segmentLength > 0 && (position == 0 || segmentLength >= minSegmentSamples))
+            {
+                renderSegment (position, segmentLength);
+                position = eventPosition;
+            }
+
+            handleEvent (metadata.data, metadata.numBytes, eventPosition);
+        }
+
+        if (position < numSamples)
+            renderSegment (position, numSamples - position);
+    }
+};
@@ -0,0 +1,346 @@
+#include "MixKernels.h"
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+ #define ITHACA_MIX_X86 1
+ #if JUCE_MSVC
+  #define ITHACA_TARGET_SSE2
+  #define ITHACA_TARGET_AVX2
+ #else
+  #define ITHACA_TARGET_SSE2 __attribute__ ((target ("sse2")))
+  #define ITHACA_TARGET_AVX2 __attribute__ ((target ("avx2")))
+ #endif
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+ #include <arm_neon.h>
+ #define ITHACA_MIX_NEON 1
+#endif
+
+namespace MixKernels
+{
+namespace
+{
+    //==============================================================================
+    // Skalární verze - reference a dokončení zbytku za vektorovou smyčkou (od indexu start)
+
+    inline int readInt24 (const juce::uint8* p) noexcept
+    {
+        return (int) ((juce::uint32) p[0] << 8 | (juce::uint32) p[1] << 16 | (juce::uint32) p[2] << 24) >> 8;
+    }
+
+    void mixAddRampFrom (int start, float* dest, const float* src, int numSamples, float gain, float gainStep) noexcept
+    {
+        for (int i = start; i < numSamples; ++i)
+            dest[i] += src[i] * (gain + (float) i * gainStep);
+    }
+
+    void mixAddPannedFrom (int start, float* destL, float* destR, const float* src, int numSamples,
+                           float gain, float gainStep, float leftGain, float rightGain) noexcept
+    {
+        for (int i = start; i < numSamples; ++i)
+        {
+            const float value = src[i] * (gain + (float) i * gainStep);
+            destL[i] += value * leftGain;
+            destR[i] += value * rightGain;
+        }
+    }
+
+    void int16ToFloatFrom (int start, float* dest, const juce::int16* src, int numSamples, float scale) noexcept
+    {
+        for (int i = start; i < numSamples; ++i)
+            dest[i] = (float) src[i] * scale;
+    }
+
+    void int24ToFloatFrom (int start, float* dest, const juce::uint8* src, int numSamples, float scale) noexcept
+    {
+        for (int i = start; i < numSamples; ++i)
+            dest[i] = (float) readInt24 (src + 3 * i) * scale;
+    }
+
+    void mixAddRampScalar (float* dest, const float* src, int numSamples, float gain, float gainStep) noexcept
+    {
+        mixAddRampFrom (0, dest, src, numSamples, gain, gainStep);
+    }
+
+    void mixAddPannedScalar (float* destL, float* destR, const float* src, int numSamples,
+                             float gain, float gainStep, float leftGain, float rightGain) noexcept
+    {
+        mixAddPannedFrom (0, destL, destR, src, numSamples, gain, gainStep, leftGain, rightGain);
+    }
+
+    void int16ToFloatScalar (float* dest, const juce::int16* src, int numSamples, float scale) noexcept
+    {
+        int16ToFloatFrom (0, dest, src, numSamples, scale);
+    }
+
+    void int24ToFloatScalar (float* dest, const juce::uint8* src, int numSamples, float scale) noexcept
+    {
+        int24ToFloatFrom (0, dest, src, numSamples, scale);
+    }
+
+    const Functions scalarFunctions { "scalar", mixAddRampScalar, mixAddPannedScalar, int16ToFloatScalar, int24ToFloatScalar };
+
+   #if ITHACA_MIX_X86
+    //==============================================================================
+    // SSE2 - 4 vzorky na instrukci
+
+    ITHACA_TARGET_SSE2 void mixAddRampSse2 (float* dest, const float* src, int numSamples, float gain, float gainStep) noexcept
+    {
+        const __m128 g = _mm_set1_ps (gain), step = _mm_set1_ps (gainStep), four = _mm_set1_ps (4.0f);
+        __m128 index = _mm_setr_ps (0.0f, 1.0f, 2.0f, 3.0f);
+        int i = 0;
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const __m128 ramp = _mm_add_ps (g, _mm_mul_ps (index, step));
+            _mm_storeu_ps (dest + i, _mm_add_ps (_mm_loadu_ps (dest + i), _mm_mul_ps (_mm_loadu_ps (src + i), ramp)));
+            index = _mm_add_ps (index, four);
+        }
+
+        mixAddRampFrom (i, dest, src, numSamples, gain, gainStep);
+    }
+
+    ITHACA_TARGET_SSE2 void mixAddPannedSse2 (float* destL, float* destR, const float* src, int numSamples,
+                                              float gain, float gainStep, float leftGain, float rightGain) noexcept
+    {
+        const __m128 g = _mm_set1_ps (gain), step = _mm_set1_ps (gainStep), four = _mm_set1_ps (4.0f);
+        const __m128 left = _mm_set1_ps (leftGain), right = _mm_set1_ps (rightGain);
+        __m128 index = _mm_setr_ps (0.0f, 1.0f, 2.0f, 3.0f);
+        int i = 0;
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const __m128 value = _mm_mul_ps (_mm_loadu_ps (src + i), _mm_add_ps (g, _mm_mul_ps (index, step)));
+            _mm_storeu_ps (destL + i, _mm_add_ps (_mm_loadu_ps (destL + i), _mm_mul_ps (value, left)));
+            _mm_storeu_ps (destR + i, _mm_add_ps (_mm_loadu_ps (destR + i), _mm_mul_ps (value, right)));
+            index = _mm_add_ps (index, four);
+        }
+
+        mixAddPannedFrom (i, destL, destR, src, numSamples, gain, gainStep, leftGain, rightGain);
+    }
+
+    ITHACA_TARGET_SSE2 void int16ToFloatSse2 (float* dest, const juce::int16* src, int numSamples, float scale) noexcept
+    {
+        const __m128 s = _mm_set1_ps (scale);
+        int i = 0;
+
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            // Zdvojení 16bitových hodnot a aritmetický posun = znaménkové rozšíření na 32 bitů
+            const __m128i v = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (src + i));
+            const __m128i low = _mm_srai_epi32 (_mm_unpacklo_epi16 (v, v), 16);
+            const __m128i high = _mm_srai_epi32 (_mm_unpackhi_epi16 (v, v), 16);
+            _mm_storeu_ps (dest + i, _mm_mul_ps (_mm_cvtepi32_ps (low), s));
+            _mm_storeu_ps (dest + i + 4, _mm_mul_ps (_mm_cvtepi32_ps (high), s));
+        }
+
+        int16ToFloatFrom (i, dest, src, numSamples, scale);
+    }
+
+    ITHACA_TARGET_SSE2 void int24ToFloatSse2 (float* dest, const juce::uint8* src, int numSamples, float scale) noexcept
+    {
+        // SSE2 nemá přeskupení bajtů - skládá se skalárně, převod a násobení jsou vektorové
+        const __m128 s = _mm_set1_ps (scale);
+        int i = 0;
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const auto* p = src + 3 * i;
+            const __m128i v = _mm_setr_epi32 (readInt24 (p), readInt24 (p + 3), readInt24 (p + 6), readInt24 (p + 9));
+            _mm_storeu_ps (dest + i, _mm_mul_ps (_mm_cvtepi32_ps (v), s));
+        }
+
+        int24ToFloatFrom (i, dest, src, numSamples, scale);
+    }
+
+    const Functions sse2Functions { "sse2", mixAddRampSse2, mixAddPannedSse2, int16ToFloatSse2, int24ToFloatSse2 };
+
+    //==============================================================================
+    // AVX2 - 8 vzorků na instrukci
+
+    ITHACA_TARGET_AVX2 void mixAddRampAvx2 (float* dest, const float* src, int numSamples, float gain, float gainStep) noexcept
+    {
+        const __m256 g = _mm256_set1_ps (gain), step = _mm256_set1_ps (gainStep), eight = _mm256_set1_ps (8.0f);
+        __m256 index = _mm256_setr_ps (0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+        int i = 0;
+
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            const __m256 ramp = _mm256_add_ps (g, _mm256_mul_ps (index, step));
+            _mm256_storeu_ps (dest + i, _mm256_add_ps (_mm256_loadu_ps (dest + i), _mm256_mul_ps (_mm256_loadu_ps (src + i), ramp)));
+            index = _mm256_add_ps (index, eight);
+        }
+
+        mixAddRampFrom (i, dest, src, numSamples, gain, gainStep);
+    }
+
+    ITHACA_TARGET_AVX2 void mixAddPannedAvx2 (float* destL, float* destR, const float* src, int numSamples,
+                                              float gain, float gainStep, float leftGain, float rightGain) noexcept
+    {
+        const __m256 g = _mm256_set1_ps (gain), step = _mm256_set1_ps (gainStep), eight = _mm256_set1_ps (8.0f);
+        const __m256 left = _mm256_set1_ps (leftGain), right = _mm256_set1_ps (rightGain);
+        __m256 index = _mm256_setr_ps (0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+        int i = 0;
+
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            const __m256 value = _mm256_mul_ps (_mm256_loadu_ps (src + i), _mm256_add_ps (g, _mm256_mul_ps (index, step)));
+            _mm256_storeu_ps (destL + i, _mm256_add_ps (_mm256_loadu_ps (destL + i), _mm256_mul_ps (value, left)));
+            _mm256_storeu_ps (destR + i, _mm256_add_ps (_mm256_loadu_ps (destR + i), _mm256_mul_ps (value, right)));
+            index = _mm256_add_ps (index, eight);
+        }
+
+        mixAddPannedFrom (i, destL, destR, src, numSamples, gain, gainStep, leftGain, rightGain);
+    }
+
+    ITHACA_TARGET_AVX2 void int16ToFloatAvx2 (float* dest, const juce::int16* src, int numSamples, float scale) noexcept
+    {
+        const __m256 s = _mm256_set1_ps (scale);
+        int i = 0;
+
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            const __m256i v = _mm256_cvtepi16_epi32 (_mm_loadu_si128 (reinterpret_cast<const __m128i*> (src + i)));
+            _mm256_storeu_ps (dest + i, _mm256_mul_ps (_mm256_cvtepi32_ps (v), s));
+        }
+
+        int16ToFloatFrom (i, dest, src, numSamples, scale);
+    }
+
+    ITHACA_TARGET_AVX2 void int24ToFloatAvx2 (float* dest, const juce::uint8* src, int numSamples, float scale) noexcept
+    {
+        // Bajty 4 vzorků do horních 24 bitů každé 32bitové složky, pak aritmetický posun o 8
+        const __m256i shuffle = _mm256_setr_epi8 (-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+                                                  -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+        const __m256 s = _mm256_set1_ps (scale);
+        int i = 0;
+
+        // Dvě 16bajtová čtení (od 0 a od 12) sahají na 28. bajt - stačí 10 zbývajících vzorků
+        for (; i + 10 <= numSamples; i += 8)
+        {
+            const auto* p = src + 3 * i;
+            const __m128i low = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (p));
+            const __m128i high = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (p + 12));
+            const __m256i bytes = _mm256_inserti128_si256 (_mm256_castsi128_si256 (low), high, 1);
+            const __m256i values = _mm256_srai_epi32 (_mm256_shuffle_epi8 (bytes, shuffle), 8);
+            _mm256_storeu_ps (dest + i, _mm256_mul_ps (_mm256_cvtepi32_ps (values), s));
+        }
+
+        int24ToFloatFrom (i, dest, src, numSamples, scale);
+    }
+
+    const Functions avx2Functions { "avx2", mixAddRampAvx2, mixAddPannedAvx2, int16ToFloatAvx2, int24ToFloatAvx2 };
+   #endif
+
+   #if ITHACA_MIX_NEON
+    //==============================================================================
+    // NEON - 4 vzorky na instrukci (násobení a sčítání zvlášť, stejně jako skalární verze)
+
+    void mixAddRampNeon (float* dest, const float* src, int numSamples, float gain, float gainStep) noexcept
+    {
+        const float32x4_t g = vdupq_n_f32 (gain), step = vdupq_n_f32 (gainStep), four = vdupq_n_f32 (4.0f);
+        const float lanes[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+        float32x4_t index = vld1q_f32 (lanes);
+        int i = 0;
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const float32x4_t ramp = vaddq_f32 (g, vmulq_f32 (index, step));
+            vst1q_f32 (dest + i, vaddq_f32 (vld1q_f32 (dest + i), vmulq_f32 (vld1q_f32 (src + i), ramp)));
+            index = vaddq_f32 (index, four);
+        }
+
+        mixAddRampFrom (i, dest, src, numSamples, gain, gainStep);
+    }
+
+    void mixAddPannedNeon (float* destL, float* destR, const float* src, int numSamples,
+                           float gain, float gainStep, float leftGain, float rightGain) noexcept
+    {
+        const float32x4_t g = vdupq_n_f32 (gain), step = vdupq_n_f32 (gainStep), four = vdupq_n_f32 (4.0f);
+        const float lanes[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+        float32x4_t index = vld1q_f32 (lanes);
+        int i = 0;
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const float32x4_t value = vmulq_f32 (vld1q_f32 (src + i), vaddq_f32 (g, vmulq_f32 (index, step)));
+            vst1q_f32 (destL + i, vaddq_f32 (vld1q_f32 (destL + i), vmulq_n_f32 (value, leftGain)));
+            vst1q_f32 (destR + i, vaddq_f32 (vld1q_f32 (destR + i), vmulq_n_f32 (value, rightGain)));
+            index = vaddq_f32 (index, four);
+        }
+
+        mixAddPannedFrom (i, destL, destR, src, numSamples, gain, gainStep, leftGain, rightGain);
+    }
+
+    void int16ToFloatNeon (float* dest, const juce::int16* src, int numSamples, float scale) noexcept
+    {
+        int i = 0;
+
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            const int16x8_t v = vld1q_s16 (src + i);
+            vst1q_f32 (dest + i, vmulq_n_f32 (vcvtq_f32_s32 (vmovl_s16 (vget_low_s16 (v))), scale));
+            vst1q_f32 (dest + i + 4, vmulq_n_f32 (vcvtq_f32_s32 (vmovl_s16 (vget_high_s16 (v))), scale));
+        }
+
+        int16ToFloatFrom (i, dest, src, numSamples, scale);
+    }
+
+    void int24ToFloatNeon (float* dest, const juce::uint8* src, int numSamples, float scale) noexcept
+    {
+        int i = 0;
+
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            // vld3 rozdělí 8 trojic na nejnižší, prostřední a nejvyšší bajty
+            const uint8x8x3_t bytes = vld3_u8 (src + 3 * i);
+            const uint16x8_t b0 = vmovl_u8 (bytes.val[0]);
+            const uint16x8_t b1 = vmovl_u8 (bytes.val[1]);
+            const uint16x8_t b2 = vmovl_u8 (bytes.val[2]);
+
+            const uint32x4_t low = vorrq_u32 (vorrq_u32 (vshlq_n_u32 (vmovl_u16 (vget_low_u16 (b0)), 8),
+                                                         vshlq_n_u32 (vmovl_u16 (vget_low_u16 (b1)), 16)),
+                                              vshlq_n_u32 (vmovl_u16 (vget_low_u16 (b2)), 24));
+            const uint32x4_t high = vorrq_u32 (vorrq_u32 (vshlq_n_u32 (vmovl_u16 (vget_high_u16 (b0)), 8),
+                                                          vshlq_n_u32 (vmovl_u16 (vget_high_u16 (b1)), 16)),
+                                               vshlq_n_u32 (vmovl_u16 (vget_high_u16 (b2)), 24));
+
+            vst1q_f32 (dest + i, vmulq_n_f32 (vcvtq_f32_s32 (vshrq_n_s32 (vreinterpretq_s32_u32 (low), 8)), scale));
+            vst1q_f32 (dest + i + 4, vmulq_n_f32 (vcvtq_f32_s32 (vshrq_n_s32 (vreinterpretq_s32_u32 (high), 8)), scale));
+        }
+
+        int24ToFloatFrom (i, dest, src, numSamples, scale);
+    }
+
+    const Functions neonFunctions { "neon", mixAddRampNeon, mixAddPannedNeon, int16ToFloatNeon, int24ToFloatNeon };
+   #endif
+}
+
+//==============================================================================
+const Functions& getScalar() noexcept
+{
+    return scalarFunctions;
+}
+
+juce::Array<const Functions*> getAvailable()
+{
+    juce::Array<const Functions*> available { &scalarFunctions };
+
+   #if ITHACA_MIX_X86
+    if (juce::SystemStats::hasSSE2())
+        available.add (&sse2Functions);
+
+    if (juce::SystemStats::hasAVX2())
+        available.add (&avx2Functions);
+   #elif ITHACA_MIX_NEON
+    available.add (&neonFunctions);
+   #endif
+
+    return available;
+}
+
+const Functions& get() noexcept
+{
+    static const Functions& selected = *getAvailable().getLast();
+    return selected;
+}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <cmath>
+
+/**
+ * MixKernels - vektorová jádra pro sčítání hlasů do výstupu a převod PCM.
+ *
+ *  - mixAddRamp:   dest[i] += src[i] * (gain + i * gainStep)
+ *  - mixAddPanned: destL/R[i] += src[i] * (gain + i * gainStep) * leftGain/rightGain
+ *                  (mono zdroj do sterea, strany viz getConstantPowerGains)
+ *  - int16ToFloat: dest[i] = src[i] * scale
+ *  - int24ToFloat: dest[i] = packed int24 (3 bajty little-endian) * scale
+ *
+ * Každé jádro má skalární, SSE2, AVX2 a NEON verzi; get() vybere za běhu
+ * nejlepší, kterou podporuje CPU (AVX2 se kompiluje pro cíl funkce, takže
+ * nevyžaduje /arch přepínač celého projektu). Rampa se počítá jako
+ * gain + i * gainStep, ne kumulativně, takže všechny verze dávají stejné
+ * hodnoty (převody bitově přesně; mix až na případné FMA kontrakce).
+ * Shodu se skalární verzí ověřuje IthacaBenchmark --verify-kernels.
+ *
+ * Ukazatele nemusí být zarovnané; dest a src se nesmí překrývat.
+ */
+namespace MixKernels
+{
+    struct Functions
+    {
+        const char* name;
+        void (*mixAddRamp) (float* dest, const float* src, int numSamples, float gain, float gainStep) noexcept;
+        void (*mixAddPanned) (float* destL, float* destR, const float* src, int numSamples,
+                              float gain, float gainStep, float leftGain, float rightGain) noexcept;
+        void (*int16ToFloat) (float* dest, const juce::int16* src, int numSamples, float scale) noexcept;
+        void (*int24ToFloat) (float* dest, const juce::uint8* src, int numSamples, float scale) noexcept;
+    };
+
+    // Nejrychlejší verze podporovaná tímto CPU (vybírá se jednou, pak je volání jen přes ukazatel)
+    const Functions& get() noexcept;
+
+    // Referenční skalární verze
+    const Functions& getScalar() noexcept;
+
+    // Všechny verze použitelné na tomto CPU včetně skalární (pro ověření a benchmark)
+    juce::Array<const Functions*> getAvailable();
+
+    /**
+     * Constant-power pan (0 = vlevo, 0.5 = střed, 1 = vpravo) normalizovaný
+     * na jednotkový zisk ve středu: sqrt(2) * cos / sin (pan * pi / 2).
+     */
+    inline void getConstantPowerGains (float pan, float& left, float& right) noexcept
+    {
+        const float angle = juce::jlimit (0.0f, 1.0f, pan) * juce::MathConstants<float>::halfPi;
+        left = juce::MathConstants<float>::sqrt2 * std::cos (angle);
+        right = juce::MathConstants<float>::sqrt2 * std::sin (angle);
+    }
+}
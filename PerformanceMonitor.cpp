@@ -0,0 +1,118 @@
+#include "PerformanceMonitor.h"
+
+void PerformanceMonitor::prepare (double newSampleRate, int samplesPerBlock) noexcept
+{
+    sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+    ticksPerSecond = (double) juce::Time::getHighResolutionTicksPerSecond();
+
+    const double deadlineSeconds = juce::jmax (1, samplesPerBlock) / sampleRate;
+    store (nominalDeadlineMicros, deadlineSeconds * 1.0e6);
+
+    // Průměr zátěže přes ~1 s audia bez ohledu na velikost bloku
+    averageCoefficient = juce::jlimit (1.0e-4, 1.0, deadlineSeconds);
+
+    resetPeaks();
+}
+
+void PerformanceMonitor::endBlock (juce::int64 startTicks, int numSamples, int voices, int events,
+                                   juce::uint64 underruns) noexcept
+{
+    const double micros = (double) (juce::Time::getHighResolutionTicks() - startTicks) * 1.0e6 / ticksPerSecond;
+    const double deadline = juce::jmax (1, numSamples) * 1.0e6 / sampleRate;
+    const double blockLoad = micros / deadline;
+
+    if (resetRequested.exchange (false, std::memory_order_relaxed))
+    {
+        store (maxBlockMicros, 0.0);
+        store (peakLoad, 0.0);
+        store (averageLoad, blockLoad);
+        peakVoices.store (0, std::memory_order_relaxed);
+        peakMidiEvents.store (0, std::memory_order_relaxed);
+        overloadedBlocks.store (0, std::memory_order_relaxed);
+        blocks.store (0, std::memory_order_relaxed);
+
+        for (auto& bin : loadHistogram)
+            bin.store (0, std::memory_order_relaxed);
+    }
+
+    // Jediný zapisovatel - load + store místo read-modify-write
+    const auto relaxed = std::memory_order_relaxed;
+    blocks.store (blocks.load (relaxed) + 1, relaxed);
+
+    if (blockLoad > 1.0)
+        overloadedBlocks.store (overloadedBlocks.load (relaxed) + 1, relaxed);
+
+    store (lastBlockMicros, micros);
+    store (lastLoad, blockLoad);
+    store (averageLoad, load (averageLoad) + averageCoefficient * (blockLoad - load (averageLoad)));
+
+    if (micros > load (maxBlockMicros))
+        store (maxBlockMicros, micros);
+
+    if (blockLoad > load (peakLoad))
+        store (peakLoad, blockLoad);
+
+    activeVoices.store (voices, relaxed);
+    if (voices > peakVoices.load (relaxed))
+        peakVoices.store (voices, relaxed);
+
+    midiEvents.store (events, relaxed);
+    if (events > peakMidiEvents.load (relaxed))
+        peakMidiEvents.store (events, relaxed);
+
+    streamUnderruns.store (underruns, relaxed);
+
+    const int bin = juce::jlimit (0, numLoadBins - 1, (int) (blockLoad / loadPerBin));
+    loadHistogram[(size_t) bin].store (loadHistogram[(size_t) bin].load (relaxed) + 1, relaxed);
+}
+
+PerformanceMonitor::Snapshot PerformanceMonitor::getSnapshot() const noexcept
+{
+    const auto relaxed = std::memory_order_relaxed;
+
+    Snapshot snapshot;
+    snapshot.blocks = blocks.load (relaxed);
+    snapshot.overloadedBlocks = overloadedBlocks.load (relaxed);
+    snapshot.deadlineMicros = load (nominalDeadlineMicros);
+    snapshot.lastBlockMicros = load (lastBlockMicros);
+    snapshot.maxBlockMicros = load (maxBlockMicros);
+    snapshot.lastLoad = load (lastLoad);
+    snapshot.averageLoad = load (averageLoad);
+    snapshot.peakLoad = load (peakLoad);
+    snapshot.activeVoices = activeVoices.load (relaxed);
+    snapshot.peakVoices = peakVoices.load (relaxed);
+    snapshot.midiEvents = midiEvents.load (relaxed);
+    snapshot.peakMidiEvents = peakMidiEvents.load (relaxed);
+    snapshot.streamUnderruns = streamUnderruns.load (relaxed);
+
+    std::array<juce::uint32, numLoadBins> counts;
+    juce::uint64 total = 0;
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        counts[i] = loadHistogram[i].load (relaxed);
+        total += counts[i];
+    }
+
+    snapshot.p50Load = percentileFromHistogram (counts, total, 0.50);
+    snapshot.p99Load = percentileFromHistogram (counts, total, 0.99);
+    return snapshot;
+}
+
+double PerformanceMonitor::percentileFromHistogram (const std::array<juce::uint32, numLoadBins>& counts,
+                                                    juce::uint64 total, double fraction) const noexcept
+{
+    if (total == 0)
+        return 0.0;
+
+    const auto target = (juce::uint64) std::ceil (fraction * (double) total);
+    juce::uint64 cumulative = 0;
+
+    for (int i = 0; i < numLoadBins; ++i)
+    {
+        cumulative += counts[(size_t) i];
+        if (cumulative >= target)
+            return (i + 1) * loadPerBin;
+    }
+
+    return numLoadBins * loadPerBin;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+
+/**
+ * Třída PerformanceMonitor - měření audio vlákna (DESIGN2.md, "PerformanceMonitor").
+ *
+ * Audio vlákno na konci každého bloku zapíše dobu zpracování (high-resolution
+ * ticky), zátěž vůči deadlinu bloku, počet aktivních hlasů, MIDI událostí
+ * a podtečení streamu. Zapisuje jen audio vlákno (jediný writer), takže stačí
+ * relaxed atomiky bez read-modify-write a bez zámků. Čtenáři (editor, benchmark)
+ * skládají snímek z atomik a audio vlákno na ně nikdy nečeká; jednotlivé
+ * hodnoty snímku mohou pocházet z různých bloků.
+ *
+ * Histogram zátěže má koše po 2 % deadlinu (poslední koš = přetížení nad 254 %).
+ * Vrcholy a histogram se nulují na žádost čtenáře; provede to audio vlákno
+ * na začátku dalšího zápisu.
+ */
+class PerformanceMonitor
+{
+public:
+    static constexpr int numLoadBins = 128;
+    static constexpr double loadPerBin = 0.02;
+
+    struct Snapshot
+    {
+        juce::uint64 blocks = 0;
+        juce::uint64 overloadedBlocks = 0;  // Blok trval déle než jeho deadline
+        double deadlineMicros = 0.0;        // Nominální deadline z prepare()
+        double lastBlockMicros = 0.0;
+        double maxBlockMicros = 0.0;
+        double lastLoad = 0.0;              // Doba bloku / deadline (1.0 = 100 %)
+        double averageLoad = 0.0;           // Exponenciální průměr (~1 s)
+        double peakLoad = 0.0;
+        double p50Load = 0.0;               // Z histogramu (horní mez koše)
+        double p99Load = 0.0;
+        int activeVoices = 0;
+        int peakVoices = 0;
+        int midiEvents = 0;                 // V posledním bloku
+        int peakMidiEvents = 0;
+        juce::uint64 streamUnderruns = 0;
+    };
+
+    PerformanceMonitor() = default;
+
+    // Deadline bloku ze sample rate a velikosti bloku (mimo audio vlákno, před prvním blokem)
+    void prepare (double sampleRate, int samplesPerBlock) noexcept;
+
+    // Audio vlákno: začátek bloku
+    static juce::int64 beginBlock() noexcept { return juce::Time::getHighResolutionTicks(); }
+
+    // Audio vlákno: konec bloku; deadline se počítá ze skutečné délky bloku
+    void endBlock (juce::int64 startTicks, int numSamples, int activeVoices, int midiEvents,
+                   juce::uint64 streamUnderruns) noexcept;
+
+    // Libovolné vlákno mimo audio; nikdy neblokuje audio vlákno
+    Snapshot getSnapshot() const noexcept;
+
+    // Vynulování vrcholů a histogramu (provede audio vlákno v dalším bloku)
+    void resetPeaks() noexcept { resetRequested.store (true, std::memory_order_relaxed); }
+
+private:
+    static void store (std::atomic<double>& target, double value) noexcept { target.store (value, std::memory_order_relaxed); }
+    static double load (const std::atomic<double>& source) noexcept { return source.load (std::memory_order_relaxed); }
+
+    double percentileFromHistogram (const std::array<juce::uint32, numLoadBins>& counts, juce::uint64 total, double fraction) const noexcept;
+
+    // Nastavuje prepare()
+    double ticksPerSecond = 1.0;
+    double sampleRate = 44100.0;
+    std::atomic<double> nominalDeadlineMicros { 0.0 };
+    double averageCoefficient = 0.01;
+
+    // Zapisuje jen audio vlákno
+    std::atomic<juce::uint64> blocks { 0 };
+    std::atomic<juce::uint64> overloadedBlocks { 0 };
+    std::atomic<double> lastBlockMicros { 0.0 };
+    std::atomic<double> maxBlockMicros { 0.0 };
+    std::atomic<double> lastLoad { 0.0 };
+    std::atomic<double> averageLoad { 0.0 };
+    std::atomic<double> peakLoad { 0.0 };
+    std::atomic<int> activeVoices { 0 };
+    std::atomic<int> peakVoices { 0 };
+    std::atomic<int> midiEvents { 0 };
+    std::atomic<int> peakMidiEvents { 0 };
+    std::atomic<juce::uint64> streamUnderruns { 0 };
+    std::array<std::atomic<juce::uint32>, numLoadBins> loadHistogram {};
+
+    std::atomic<bool> resetRequested { false };
+
+    JUCE_DECLARE_NON_COPYABLE (PerformanceMonitor)
+};
@@ -9,27 +9,19 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAud
     juce::ignoreUnused (processorRef);
     
     // Logování vytváření editoru
-    Logger::getInstance().log("PluginEditor/constructor", "info", "=== INICIALIZACE GUI ===");
-    Logger::getInstance().log("PluginEditor/constructor", "info", "Vytvářeni komponenty editoru");
+    ITHACA_LOG_INFO("PluginEditor/constructor", "=== INICIALIZACE GUI ===");
+    ITHACA_LOG_INFO("PluginEditor/constructor", "Vytvářeni komponenty editoru");
     
-    // Inicializace log display (multiline, read-only, se scrollbar)
-    logDisplay = std::make_unique<juce::TextEditor>();
-    logDisplay->setMultiLine(true);
-    logDisplay->setReadOnly(true);
-    logDisplay->setScrollbarsShown(true);
+    // Inicializace log display (virtualizovaný seznam, kreslí jen viditelné řádky)
+    logDisplay = std::make_unique<LogView>();
     
     // Oprava deprecated Font konstruktoru
     juce::Font monoFont(juce::FontOptions(juce::Font::getDefaultMonospacedFontName(), 11.0f, juce::Font::plain));
     logDisplay->setFont(monoFont);
     
-    // Styling pro lepší čitelnost
-    logDisplay->setColour(juce::TextEditor::backgroundColourId, juce::Colour(0xff1e1e1e)); // Tmavě šedé pozadí
-    logDisplay->setColour(juce::TextEditor::textColourId, juce::Colour(0xff00ff00));        // Zelený text (matrix style)
-    logDisplay->setColour(juce::TextEditor::outlineColourId, juce::Colour(0xff404040));     // Tmavý okraj
-    
     addAndMakeVisible(logDisplay.get());
     
-    Logger::getInstance().log("PluginEditor/constructor", "info", "Log display inicializovan s matrix theme");
+    ITHACA_LOG_INFO("PluginEditor/constructor", "Log display inicializovan s matrix theme");
 
     // Inicializace toggle tlačítka
     toggleLogging = std::make_unique<juce::ToggleButton>("Zapnout/Vypnout logovani");
@@ -37,7 +29,7 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAud
     toggleLogging->onClick = [this] {
         bool newState = toggleLogging->getToggleState();
         Logger::loggingEnabled = newState;
-        Logger::getInstance().log("PluginEditor/toggleButton", "info", 
+        ITHACA_LOG_INFO("PluginEditor/toggleButton", 
             "Logovani " + juce::String(newState ? "ZAPNUTO" : "VYPNUTO"));
         if (!Logger::loggingEnabled) {
             logDisplay->clear();  // Vyčištění display při vypnutí
@@ -45,38 +37,51 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAud
     };
     addAndMakeVisible(toggleLogging.get());
     
-    Logger::getInstance().log("PluginEditor/constructor", "info", "Toggle button inicializovan");
+    ITHACA_LOG_INFO("PluginEditor/constructor", "Toggle button inicializovan");
+
+    // Zápis celé relace logu na disk (LogJournal) - nastavení instance, ukládá se do projektu
+    toggleJournal = std::make_unique<juce::ToggleButton>("Journal logu na disk");
+    toggleJournal->setToggleState(processorRef.getSamplerSettings().writeLogJournal, juce::dontSendNotification);
+    toggleJournal->onClick = [this] {
+        processorRef.setLogJournalEnabled(toggleJournal->getToggleState());
+    };
+    addAndMakeVisible(toggleJournal.get());
 
     // Přidání tlačítka pro vyčištění logů
     clearLogsButton = std::make_unique<juce::TextButton>("Vycistit logy");
     clearLogsButton->onClick = [this] {
         logDisplay->clear();
-        Logger::getInstance().log("PluginEditor/clearButton", "info", "=== LOGY VYCISTENY UZIVATELEM ===");
+        ITHACA_LOG_INFO("PluginEditor/clearButton", "=== LOGY VYCISTENY UZIVATELEM ===");
     };
     addAndMakeVisible(clearLogsButton.get());
     
-    Logger::getInstance().log("PluginEditor/constructor", "info", "Clear button inicializovan");
+    ITHACA_LOG_INFO("PluginEditor/constructor", "Clear button inicializovan");
 
-    // Nastavení reference na tento editor v Loggeru
-    Logger::getInstance().setEditor(this);
-    Logger::getInstance().log("PluginEditor/constructor", "info", "Reference na editor nastavena v Loggeru");
+    // Progress bar načítání nástroje - hodnotu aktualizuje timer editoru
+    loadProgressBar = std::make_unique<juce::ProgressBar>(loadProgressValue);
+    addAndMakeVisible(loadProgressBar.get());
+
+    performanceLabel = std::make_unique<juce::Label>();
+    performanceLabel->setFont(monoFont);
+    performanceLabel->setColour(juce::Label::textColourId, juce::Colours::lightgrey);
+    addAndMakeVisible(performanceLabel.get());
+    startTimerHz(10);
 
     // Rozšířená velikost okna na 800x500
     setSize (1024, 600);
-    Logger::getInstance().log("PluginEditor/constructor", "info", "Velikost okna nastavena: 800x500");
-    Logger::getInstance().log("PluginEditor/constructor", "info", "=== GUI INICIALIZACE DOKONČENA ===");
+    ITHACA_LOG_INFO("PluginEditor/constructor", "Velikost okna nastavena: 800x500");
+    ITHACA_LOG_INFO("PluginEditor/constructor", "=== GUI INICIALIZACE DOKONČENA ===");
 }
 
 AudioPluginAudioProcessorEditor::~AudioPluginAudioProcessorEditor()
 {
+    stopTimer();
+
     // Logování před destrukcí
-    Logger::getInstance().log("PluginEditor/destructor", "info", "=== UZAVIRANI GUI ===");
-    Logger::getInstance().log("PluginEditor/destructor", "info", "Zahajeni destrukce editoru");
-    
-    // Odstranění reference při destrukci
-    Logger::getInstance().setEditor(nullptr);
-    Logger::getInstance().log("PluginEditor/destructor", "info", "Reference na editor odstranena");
-    Logger::getInstance().log("PluginEditor/destructor", "info", "=== GUI UZAVRENO ===");
+    ITHACA_LOG_INFO("PluginEditor/destructor", "=== UZAVIRANI GUI ===");
+    ITHACA_LOG_INFO("PluginEditor/destructor", "Zahajeni destrukce editoru");
+
+    ITHACA_LOG_INFO("PluginEditor/destructor", "=== GUI UZAVRENO ===");
 }
 
 //==============================================================================
@@ -86,8 +91,8 @@ void AudioPluginAudioProcessorEditor::paint (juce::Graphics& g)
     static bool firstPaint = true;
     if (firstPaint)
     {
-        Logger::getInstance().log("PluginEditor/paint", "info", "=== PRVNI VYKRESLENI GUI ===");
-        Logger::getInstance().log("PluginEditor/paint", "info", "Rozmery canvas: " + 
+        ITHACA_LOG_INFO("PluginEditor/paint", "=== PRVNI VYKRESLENI GUI ===");
+        ITHACA_LOG_INFO("PluginEditor/paint", "Rozmery canvas: " + 
             juce::String(getWidth()) + "x" + juce::String(getHeight()));
         firstPaint = false;
     }
@@ -115,7 +120,7 @@ void AudioPluginAudioProcessorEditor::paint (juce::Graphics& g)
 void AudioPluginAudioProcessorEditor::resized()
 {
     // Logování změny velikosti
-    Logger::getInstance().log("PluginEditor/resized", "debug", "Zmena velikosti GUI: " + 
+    ITHACA_LOG_DEBUG("PluginEditor/resized", "Zmena velikosti GUI: " + 
         juce::String(getWidth()) + "x" + juce::String(getHeight()));
     
     // Layout - rozložení komponent
@@ -124,41 +129,53 @@ void AudioPluginAudioProcessorEditor::resized()
     int headerHeight = 90;  // Prostor pro nadpis
     
     // Log display zabírá většinu místa
-    int logDisplayHeight = getHeight() - headerHeight - buttonHeight * 2 - margin * 4;
+    int logDisplayHeight = getHeight() - headerHeight - buttonHeight * 3 - margin * 5;
     logDisplay->setBounds(margin, headerHeight, getWidth() - 2 * margin, logDisplayHeight);
 
     // Tlačítka ve spodní části
     int buttonY = headerHeight + logDisplayHeight + margin;
-    int buttonWidth = (getWidth() - 3 * margin) / 2;
+    int buttonWidth = (getWidth() - 4 * margin) / 3;
     
     toggleLogging->setBounds(margin, buttonY, buttonWidth, buttonHeight);
-    clearLogsButton->setBounds(margin * 2 + buttonWidth, buttonY, buttonWidth, buttonHeight);
+    toggleJournal->setBounds(margin * 2 + buttonWidth, buttonY, buttonWidth, buttonHeight);
+    clearLogsButton->setBounds(margin * 3 + buttonWidth * 2, buttonY, buttonWidth, buttonHeight);
+
+    // Progress načítání nástroje pod tlačítky
+    loadProgressBar->setBounds(margin, buttonY + buttonHeight + margin, getWidth() - 2 * margin, buttonHeight);
+    performanceLabel->setBounds(margin, buttonY + (buttonHeight + margin) * 2, getWidth() - 2 * margin, buttonHeight);
     
-    Logger::getInstance().log("PluginEditor/resized", "debug", "Layout komponent aktualizovan - log area: " + 
+    ITHACA_LOG_DEBUG("PluginEditor/resized", "Layout komponent aktualizovan - log area: " + 
         juce::String(logDisplay->getWidth()) + "x" + juce::String(logDisplay->getHeight()));
 }
 
 /**
- * Aktualizace log display s auto-scroll na konec.
+ * Aktualizace průběhu načítání nástroje (bez zámků, čte atomické čítače loaderu).
  */
-void AudioPluginAudioProcessorEditor::updateLogDisplay()
+void AudioPluginAudioProcessorEditor::timerCallback()
 {
-    // Získání bufferu z Loggeru přes getter
-    const juce::StringArray& buffer = Logger::getInstance().getLogBuffer();
+    const auto progress = processorRef.getLibraryLoadProgress();
 
-    // Sestavení textu
-    juce::String logText;
-    for (const auto& entry : buffer)
+    if (progress.loading)
+    {
+        loadProgressValue = progress.getFraction();
+        loadProgressBar->setTextToDisplay("Nacitani nastroje: " + juce::String(progress.filesDone) + " / "
+            + juce::String(progress.filesTotal) + " souboru (" + juce::String(progress.bytesDone / (1024 * 1024)) + " / "
+            + juce::String(progress.bytesTotal / (1024 * 1024)) + " MB)");
+    }
+    else
     {
-        logText += entry + "\n";
+        loadProgressValue = 1.0;
+        loadProgressBar->setTextToDisplay("Nastroj nacten");
     }
 
-    // Nastavení textu
-    logDisplay->setText(logText);
+    const auto perf = processorRef.getPerformanceMonitor().getSnapshot();
+    performanceLabel->setText("CPU " + juce::String(perf.averageLoad * 100.0, 1) + " % (p99 " + juce::String(perf.p99Load * 100.0, 0)
+        + " %, max " + juce::String(perf.peakLoad * 100.0, 0) + " %) | blok " + juce::String(perf.lastBlockMicros, 0) + " / "
+        + juce::String(perf.deadlineMicros, 0) + " us | pretizeno " + juce::String((juce::int64) perf.overloadedBlocks)
+        + " | hlasy " + juce::String(perf.activeVoices) + " (max " + juce::String(perf.peakVoices) + ") | MIDI/blok max "
+        + juce::String(perf.peakMidiEvents) + " | podteceni " + juce::String((juce::int64) perf.streamUnderruns),
+        juce::dontSendNotification);
 
-    // Auto-scroll na konec pro sledování nových událostí
-    logDisplay->moveCaretToEnd();
-    
-    // Jednoduchý scroll na konec
-    logDisplay->scrollEditorToPositionCaret(0, logDisplay->getHeight() - 20);
-}
\ No newline at end of file
+    // Stav mohl změnit hostitel (setStateInformation)
+    toggleJournal->setToggleState(processorRef.getSamplerSettings().writeLogJournal, juce::dontSendNotification);
+}
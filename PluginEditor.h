@@ -1,10 +1,12 @@
 #pragma once
 
 #include "PluginProcessor.h"
+#include "LogView.h"
 #include <juce_gui_basics/juce_gui_basics.h>
 
 //==============================================================================
-class AudioPluginAudioProcessorEditor final : public juce::AudioProcessorEditor
+class AudioPluginAudioProcessorEditor final : public juce::AudioProcessorEditor,
+                                              private juce::Timer
 {
 public:
     explicit AudioPluginAudioProcessorEditor (AudioPluginAudioProcessor&);
@@ -14,17 +16,25 @@ public:
     void paint (juce::Graphics&) override;
     void resized() override;
 
-    // Metoda pro aktualizaci log display
-    void updateLogDisplay();
-
 private:
+    // Periodické čtení průběhu načítání nástroje
+    void timerCallback() override;
+
     // Reference na procesor
     AudioPluginAudioProcessor& processorRef;
 
     // Komponenty pro logování a ovládání
-    std::unique_ptr<juce::TextEditor> logDisplay;
+    std::unique_ptr<LogView> logDisplay;
     std::unique_ptr<juce::ToggleButton> toggleLogging;
+    std::unique_ptr<juce::ToggleButton> toggleJournal;
     std::unique_ptr<juce::TextButton> clearLogsButton;
 
+    // Průběh načítání nástroje (ProgressBar čte hodnotu sám)
+    double loadProgressValue = 0.0;
+    std::unique_ptr<juce::ProgressBar> loadProgressBar;
+
+    // Zátěž audio vlákna z PerformanceMonitor
+    std::unique_ptr<juce::Label> performanceLabel;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioPluginAudioProcessorEditor)
 };
\ No newline at end of file
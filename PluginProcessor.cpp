@@ -1,6 +1,31 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+namespace
+{
+    // Nastavení, která mění obsah nástroje - jejich změna vyžaduje nové načtení
+    bool requiresLibraryReload (const SamplerSettings& a, const SamplerSettings& b)
+    {
+        return a.sampleDirectory != b.sampleDirectory
+            || a.generateMissingNotes != b.generateMissingNotes
+            || a.useSampleCache != b.useSampleCache
+            || a.sampleStorage != b.sampleStorage
+            || a.streamFromDisk != b.streamFromDisk
+            || a.preloadMilliseconds != b.preloadMilliseconds;
+    }
+
+    // Nastavení, která mění rozložení hlasů a DFD slotů v enginu
+    bool requiresEnginePrepare (const SamplerSettings& a, const SamplerSettings& b)
+    {
+        return a.maxVoices != b.maxVoices
+            || a.stealPolicy != b.stealPolicy
+            || a.sampleStorage != b.sampleStorage
+            || a.streamFromDisk != b.streamFromDisk
+            || a.streamBufferFrames != b.streamBufferFrames
+            || a.numStreamingThreads != b.numStreamingThreads;
+    }
+}
+
 //==============================================================================
 AudioPluginAudioProcessor::AudioPluginAudioProcessor()
      : AudioProcessor (BusesProperties()
@@ -12,20 +37,27 @@ AudioPluginAudioProcessor::AudioPluginAudioProcessor()
                      #endif
                        )
 {
-    Logger::getInstance().log("AudioPluginAudioProcessor/constructor", "info", "=== APLIKACE SPUSTENA ===");
-    Logger::getInstance().log("AudioPluginAudioProcessor/constructor", "info", "Inicializace procesoru");
-    Logger::getInstance().log("AudioPluginAudioProcessor/constructor", "info", "Plugin nazev: " + getName());
-    Logger::getInstance().log("AudioPluginAudioProcessor/constructor", "info", "Je synthesizer: " + juce::String(JucePlugin_IsSynth ? "ANO" : "NE"));
-    Logger::getInstance().log("AudioPluginAudioProcessor/constructor", "info", "Prijima MIDI: " + juce::String(acceptsMidi() ? "ANO" : "NE"));
-    Logger::getInstance().log("AudioPluginAudioProcessor/constructor", "info", "Produkuje MIDI: " + juce::String(producesMidi() ? "ANO" : "NE"));
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/constructor", "=== APLIKACE SPUSTENA ===");
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/constructor", "Inicializace procesoru");
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/constructor", "Plugin nazev: " + getName());
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/constructor", "Je synthesizer: " + juce::String(JucePlugin_IsSynth ? "ANO" : "NE"));
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/constructor", "Prijima MIDI: " + juce::String(acceptsMidi() ? "ANO" : "NE"));
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/constructor", "Produkuje MIDI: " + juce::String(producesMidi() ? "ANO" : "NE"));
+
+    rtLogger.startDrainer();
+    updateLogJournal();
 }
 
 AudioPluginAudioProcessor::~AudioPluginAudioProcessor()
 {
-    Logger::getInstance().log("AudioPluginAudioProcessor/destructor", "info", "=== APLIKACE SE UKONCUJE ===");
-    Logger::getInstance().log("AudioPluginAudioProcessor/destructor", "info", "Zahajeni destrukce procesoru");
-    Logger::getInstance().setEditor(nullptr);
-    Logger::getInstance().log("AudioPluginAudioProcessor/destructor", "info", "=== DESTRUKCE DOKONCENA ===");
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/destructor", "=== APLIKACE SE UKONCUJE ===");
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/destructor", "Zahajeni destrukce procesoru");
+    rtLogger.stopDrainer();
+
+    if (writesLogJournal)
+        logJournal->removeWriter();
+
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/destructor", "=== DESTRUKCE DOKONCENA ===");
 }
 
 const juce::String AudioPluginAudioProcessor::getName() const
@@ -62,7 +94,8 @@ bool AudioPluginAudioProcessor::isMidiEffect() const
 
 double AudioPluginAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // Nejdelší doznívání po note-off = release time obálky (čas do -80 dB) zpomalený half-pedalem
+    return samplerEngine.getTailLengthSeconds();
 }
 
 int AudioPluginAudioProcessor::getNumPrograms()
@@ -77,7 +110,7 @@ int AudioPluginAudioProcessor::getCurrentProgram()
 
 void AudioPluginAudioProcessor::setCurrentProgram (int index)
 {
-    Logger::getInstance().log("AudioPluginAudioProcessor/setCurrentProgram", "info", "Zmena programu na index: " + juce::String(index));
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/setCurrentProgram", "Zmena programu na index: " + juce::String(index));
     juce::ignoreUnused (index);
 }
 
@@ -89,29 +122,104 @@ const juce::String AudioPluginAudioProcessor::getProgramName (int index)
 
 void AudioPluginAudioProcessor::changeProgramName (int index, const juce::String& newName)
 {
-    Logger::getInstance().log("AudioPluginAudioProcessor/changeProgramName", "info", "Zmena nazvu programu [" + juce::String(index) + "]: " + newName);
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/changeProgramName", "Zmena nazvu programu [" + juce::String(index) + "]: " + newName);
     juce::ignoreUnused (index, newName);
 }
 
 void AudioPluginAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    Logger::getInstance().log("AudioPluginAudioProcessor/prepareToPlay", "info", "=== PRIPRAVA AUDIO PROCESINGU ===");
-    Logger::getInstance().log("AudioPluginAudioProcessor/prepareToPlay", "info", "Sample rate: " + juce::String(sampleRate, 1) + " Hz");
-    Logger::getInstance().log("AudioPluginAudioProcessor/prepareToPlay", "info", "Buffer size: " + juce::String(samplesPerBlock) + " samples");
-    Logger::getInstance().log("AudioPluginAudioProcessor/prepareToPlay", "info", "Vstupni kanaly: " + juce::String(getTotalNumInputChannels()));
-    Logger::getInstance().log("AudioPluginAudioProcessor/prepareToPlay", "info", "Vystupni kanaly: " + juce::String(getTotalNumOutputChannels()));
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/prepareToPlay", "=== PRIPRAVA AUDIO PROCESINGU ===");
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/prepareToPlay", "Sample rate: " + juce::String(sampleRate, 1) + " Hz");
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/prepareToPlay", "Buffer size: " + juce::String(samplesPerBlock) + " samples");
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/prepareToPlay", "Vstupni kanaly: " + juce::String(getTotalNumInputChannels()));
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/prepareToPlay", "Vystupni kanaly: " + juce::String(getTotalNumOutputChannels()));
     
     // Vypocet latence
     double latencyMs = (double)samplesPerBlock / sampleRate * 1000.0;
-    Logger::getInstance().log("AudioPluginAudioProcessor/prepareToPlay", "info", "Odhadovana latence: " + juce::String(latencyMs, 2) + " ms");
-    
-    juce::ignoreUnused (sampleRate, samplesPerBlock);
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/prepareToPlay", "Odhadovana latence: " + juce::String(latencyMs, 2) + " ms");
+
+    performanceMonitor.prepare(sampleRate, samplesPerBlock);
+    prepareSampler(sampleRate, samplesPerBlock);
+}
+
+/**
+ * Předalokace hlasů (a DFD slotů) a případné spuštění načítání nástroje.
+ * Volá se mimo audio vlákno, když processBlock neběží.
+ */
+void AudioPluginAudioProcessor::prepareSampler (double sampleRate, int samplesPerBlock)
+{
+    const juce::ScopedLock sl (libraryLock);
+
+    samplerEngine.setLibrary(nullptr);
+    samplerEngine.prepare(sampleRate, samplesPerBlock, samplerSettings);
+
+    // Engine ani streamer teď nic nehrají - vyřazené nástroje lze uvolnit hned
+    retiredLibraries.clear();
+
+    // Nahrání nástroje při prvním spuštění - na pozadí, prepareToPlay nečeká
+    if (sampleLibrary == nullptr && ! libraryLoader.isLoading())
+    {
+        ITHACA_LOG_INFO("AudioPluginAudioProcessor/prepareSampler", "Nacitani vzorku z: " + samplerSettings.sampleDirectory.getFullPathName()
+            + (samplerSettings.streamFromDisk ? " (DFD, preload " + juce::String(samplerSettings.preloadMilliseconds) + " ms)" : juce::String(" (cele v pameti)")));
+
+        libraryLoader.startLoad(samplerSettings);
+    }
+
+    samplerEngine.setLibrary(sampleLibrary.get());
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/prepareSampler", "Sampler engine pripraven (" + juce::String(samplerSettings.maxVoices) + " hlasu)");
+}
+
+/**
+ * Hotový nástroj z loaderu (loader vlákno). Audio vlákno ho převezme na začátku
+ * dalšího bloku; do té doby hraje předchozí nástroj, který se pak uvolní zde.
+ */
+void AudioPluginAudioProcessor::onLibraryLoaded (std::unique_ptr<SampleLibrary> newLibrary)
+{
+    const juce::ScopedLock sl (libraryLock);
+
+    if (sampleLibrary != nullptr)
+        retiredLibraries.push_back(std::move(sampleLibrary));
+
+    sampleLibrary = std::move(newLibrary);
+    samplerEngine.requestLibrary(sampleLibrary.get());
+
+    // Nástroj se od uložení projektu na disku změnil - cache se přestavěla
+    const auto expectedFingerprint = restoredFingerprint.exchange(0);
+    if (expectedFingerprint != 0 && expectedFingerprint != sampleLibrary->getFingerprint())
+        ITHACA_LOG_WARN("AudioPluginAudioProcessor/onLibraryLoaded", 
+            "Nastroj se od ulozeni projektu zmenil (fingerprint " + juce::String::toHexString((juce::int64) expectedFingerprint)
+            + " -> " + juce::String::toHexString((juce::int64) sampleLibrary->getFingerprint()) + ")");
+
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/onLibraryLoaded", 
+        "Novy nastroj predan enginu (" + juce::String(sampleLibrary->getNumSamples()) + " vzorku)");
+
+    releaseRetiredLibraries(1000);
+}
+
+/**
+ * Smazání vyřazených nástrojů, které už engine nepoužívá. Když audio neběží,
+ * výměna se nedokončí a nástroj počká na další prepareSampler().
+ */
+void AudioPluginAudioProcessor::releaseRetiredLibraries (int timeoutMs)
+{
+    for (auto it = retiredLibraries.begin(); it != retiredLibraries.end();)
+    {
+        if (samplerEngine.waitUntilLibraryUnused(it->get(), timeoutMs))
+            it = retiredLibraries.erase(it);
+        else
+            ++it;
+    }
+
+    if (! retiredLibraries.empty())
+        ITHACA_LOG_DEBUG("AudioPluginAudioProcessor/releaseRetiredLibraries", 
+            "Vyrazene nastroje cekaji na uvolneni: " + juce::String((int) retiredLibraries.size()));
 }
 
 void AudioPluginAudioProcessor::releaseResources()
 {
-    Logger::getInstance().log("AudioPluginAudioProcessor/releaseResources", "info", "=== UVOLNOVANI AUDIO ZDROJU ===");
-    Logger::getInstance().log("AudioPluginAudioProcessor/releaseResources", "info", "Audio processing zastaven");
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/releaseResources", "=== UVOLNOVANI AUDIO ZDROJU ===");
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/releaseResources", "Audio processing zastaven");
+    samplerEngine.reset();
 }
 
 bool AudioPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
@@ -123,13 +231,13 @@ bool AudioPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
     auto mainOutput = layouts.getMainOutputChannelSet();
     auto mainInput = layouts.getMainInputChannelSet();
     
-    Logger::getInstance().log("AudioPluginAudioProcessor/isBusesLayoutSupported", "debug", 
+    ITHACA_LOG_DEBUG("AudioPluginAudioProcessor/isBusesLayoutSupported", 
         "Kontrola layoutu - Input: " + mainInput.getDescription() + 
         ", Output: " + mainOutput.getDescription());
     
     if (mainOutput != juce::AudioChannelSet::mono() && mainOutput != juce::AudioChannelSet::stereo())
     {
-        Logger::getInstance().log("AudioPluginAudioProcessor/isBusesLayoutSupported", "warn", 
+        ITHACA_LOG_WARN("AudioPluginAudioProcessor/isBusesLayoutSupported", 
             "Nepodporovany output layout: " + mainOutput.getDescription());
         return false;
     }
@@ -137,7 +245,7 @@ bool AudioPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
    #if ! JucePlugin_IsSynth
     if (mainOutput != mainInput)
     {
-        Logger::getInstance().log("AudioPluginAudioProcessor/isBusesLayoutSupported", "warn", 
+        ITHACA_LOG_WARN("AudioPluginAudioProcessor/isBusesLayoutSupported", 
             "Input a output layout se neshoduji");
         return false;
     }
@@ -150,17 +258,18 @@ bool AudioPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
 void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
                                               juce::MidiBuffer& midiMessages)
 {
-    // Pocitadlo pro omezeni logovani
-    static int processCount = 0;
-    static int totalMidiEvents = 0;
+    const auto perfStartTicks = PerformanceMonitor::beginBlock();
+
+    // Veškeré logování z audio vlákna jde přes rtLogger - žádné alokace ani zámky
+    const auto blockStart = processedSamples;
+    processedSamples += buffer.getNumSamples();
     processCount++;
     
     // Detailni logování prvnich bloku
     if (processCount <= 5)
     {
-        Logger::getInstance().log("AudioPluginAudioProcessor/processBlock", "info", 
-            "Audio blok #" + juce::String(processCount) + " - velikost: " + juce::String(buffer.getNumSamples()) + 
-            " samples, kanaly: " + juce::String(buffer.getNumChannels()));
+        rtLogger.log (RtLogComponent::ProcessBlock, LogSeverity::Info, RtLogEvent::BlockInfo, blockStart,
+                      processCount, buffer.getNumSamples(), buffer.getNumChannels());
             
         // Analyza amplitudy pro prvni bloky
         if (buffer.getNumChannels() > 0)
@@ -174,100 +283,89 @@ void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
                     maxAmplitude = juce::jmax(maxAmplitude, std::abs(channelData[sample]));
                 }
             }
-            Logger::getInstance().log("AudioPluginAudioProcessor/processBlock", "info", 
-                "Maximalni amplituda v bloku: " + juce::String(maxAmplitude, 6));
+            rtLogger.log (RtLogComponent::ProcessBlock, LogSeverity::Info, RtLogEvent::BlockMaxAmplitude, blockStart,
+                          maxAmplitude);
         }
     }
     else if (processCount % 1000 == 0)
     {
-        Logger::getInstance().log("AudioPluginAudioProcessor/processBlock", "debug", 
-            "Zpracovano " + juce::String(processCount) + " audio bloku, celkem MIDI: " + juce::String(totalMidiEvents));
+        rtLogger.log (RtLogComponent::ProcessBlock, LogSeverity::Debug, RtLogEvent::BlockProgress, blockStart,
+                      processCount, totalMidiEvents);
     }
     
     // Detailni MIDI logování
     if (!midiMessages.isEmpty())
     {
         int midiEventsInBlock = 0;
-        Logger::getInstance().log("AudioPluginAudioProcessor/processBlock", "info", "=== MIDI UDALOSTI ===");
+        rtLogger.log (RtLogComponent::ProcessBlock, LogSeverity::Info, RtLogEvent::MidiBlockStart, blockStart);
         
-        for (const auto& midiMetadata : midiMessages)
+        for (const auto midiMetadata : midiMessages)
         {
-            auto message = midiMetadata.getMessage();
-            int sampleNumber = midiMetadata.samplePosition;
+            // getMessage() by kopírovalo data do MidiMessage - čteme přímo surové bajty
+            const auto* data = midiMetadata.data;
+            const int sampleNumber = midiMetadata.samplePosition;
+            const auto timestamp = blockStart + sampleNumber;
             midiEventsInBlock++;
             totalMidiEvents++;
-            
-            juce::String midiInfo = "MIDI #" + juce::String(totalMidiEvents) + 
-                                   " @ sample " + juce::String(sampleNumber) + ": ";
-            
-            if (message.isNoteOn())
+
+            const int status = midiMetadata.numBytes > 0 ? (data[0] & 0xf0) : 0;
+            const int data1 = midiMetadata.numBytes > 1 ? data[1] : 0;
+            const int data2 = midiMetadata.numBytes > 2 ? data[2] : 0;
+
+            if (status == 0x90 && data2 > 0)
             {
-                midiInfo += "NOTE ON - Note: " + juce::String(message.getNoteNumber()) + 
-                           " (" + message.getMidiNoteName(message.getNoteNumber(), true, true, 4) + ")" +
-                           ", Velocity: " + juce::String(message.getVelocity()) +
-                           ", Channel: " + juce::String(message.getChannel());
+                rtLogger.log (RtLogComponent::ProcessBlock, LogSeverity::Info, RtLogEvent::MidiNoteOn, timestamp,
+                              totalMidiEvents, sampleNumber, data1, data2);
             }
-            else if (message.isNoteOff())
+            else if (status == 0x80 || status == 0x90)
             {
-                midiInfo += "NOTE OFF - Note: " + juce::String(message.getNoteNumber()) + 
-                           " (" + message.getMidiNoteName(message.getNoteNumber(), true, true, 4) + ")" +
-                           ", Velocity: " + juce::String(message.getVelocity()) +
-                           ", Channel: " + juce::String(message.getChannel());
+                rtLogger.log (RtLogComponent::ProcessBlock, LogSeverity::Info, RtLogEvent::MidiNoteOff, timestamp,
+                              totalMidiEvents, sampleNumber, data1, data2);
             }
-            else if (message.isController())
+            else if (status == 0xb0)
             {
-                midiInfo += "CC - Controller: " + juce::String(message.getControllerNumber()) +
-                           ", Value: " + juce::String(message.getControllerValue()) +
-                           ", Channel: " + juce::String(message.getChannel());
+                rtLogger.log (RtLogComponent::ProcessBlock, LogSeverity::Info, RtLogEvent::MidiController, timestamp,
+                              totalMidiEvents, sampleNumber, data1, data2);
             }
-            else if (message.isPitchWheel())
+            else if (status == 0xe0)
             {
-                midiInfo += "PITCH BEND - Value: " + juce::String(message.getPitchWheelValue()) +
-                           ", Channel: " + juce::String(message.getChannel());
+                rtLogger.log (RtLogComponent::ProcessBlock, LogSeverity::Info, RtLogEvent::MidiPitchBend, timestamp,
+                              totalMidiEvents, sampleNumber, data1 | (data2 << 7));
             }
-            else if (message.isProgramChange())
+            else if (status == 0xc0)
             {
-                midiInfo += "PROGRAM CHANGE - Program: " + juce::String(message.getProgramChangeNumber()) +
-                           ", Channel: " + juce::String(message.getChannel());
+                rtLogger.log (RtLogComponent::ProcessBlock, LogSeverity::Info, RtLogEvent::MidiProgramChange, timestamp,
+                              totalMidiEvents, sampleNumber, data1);
             }
-            else if (message.isChannelPressure())
+            else if (status == 0xd0)
             {
-                midiInfo += "CHANNEL PRESSURE - Pressure: " + juce::String(message.getChannelPressureValue()) +
-                           ", Channel: " + juce::String(message.getChannel());
+                rtLogger.log (RtLogComponent::ProcessBlock, LogSeverity::Info, RtLogEvent::MidiChannelPressure, timestamp,
+                              totalMidiEvents, sampleNumber, data1);
             }
-            else if (message.isAftertouch())
+            else if (status == 0xa0)
             {
-                midiInfo += "AFTERTOUCH - Note: " + juce::String(message.getNoteNumber()) +
-                           ", Pressure: " + juce::String(message.getAfterTouchValue()) +
-                           ", Channel: " + juce::String(message.getChannel());
+                rtLogger.log (RtLogComponent::ProcessBlock, LogSeverity::Info, RtLogEvent::MidiAftertouch, timestamp,
+                              totalMidiEvents, sampleNumber, data1, data2);
             }
             else
             {
-                midiInfo += "OTHER - " + message.getDescription();
+                rtLogger.log (RtLogComponent::ProcessBlock, LogSeverity::Info, RtLogEvent::MidiOther, timestamp,
+                              totalMidiEvents, sampleNumber, midiMetadata.numBytes > 0 ? data[0] : 0, midiMetadata.numBytes);
             }
-            
-            Logger::getInstance().log("AudioPluginAudioProcessor/processBlock", "info", midiInfo);
         }
         
-        Logger::getInstance().log("AudioPluginAudioProcessor/processBlock", "info", 
-            "Celkem MIDI udalosti v bloku: " + juce::String(midiEventsInBlock));
+        rtLogger.log (RtLogComponent::ProcessBlock, LogSeverity::Info, RtLogEvent::MidiBlockSummary, blockStart,
+                      midiEventsInBlock);
     }
 
     juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels  = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
 
-    // Vyčištění přebytečných výstupních kanálů
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear (i, 0, buffer.getNumSamples());
+    // Synth nemá vstupy - výstup se plní pouze renderem hlasů
+    buffer.clear();
+    samplerEngine.renderBlock (buffer, midiMessages);
 
-    // Zde by bylo audio processing - momentálně jen passthrough
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
-    {
-        auto* channelData = buffer.getWritePointer (channel);
-        juce::ignoreUnused (channelData);
-        // TODO: Implementovat audio processing
-    }
+    performanceMonitor.endBlock (perfStartTicks, buffer.getNumSamples(), samplerEngine.getNumActiveVoices(),
+                                 midiMessages.getNumEvents(), samplerEngine.getStreamUnderrunCount());
 }
 
 bool AudioPluginAudioProcessor::hasEditor() const
@@ -277,22 +375,163 @@ bool AudioPluginAudioProcessor::hasEditor() const
 
 juce::AudioProcessorEditor* AudioPluginAudioProcessor::createEditor()
 {
-    Logger::getInstance().log("AudioPluginAudioProcessor/createEditor", "info", "=== VYTVARENI GUI EDITORU ===");
-    Logger::getInstance().log("AudioPluginAudioProcessor/createEditor", "info", "Inicializace uzivatelského rozhrani");
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/createEditor", "=== VYTVARENI GUI EDITORU ===");
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/createEditor", "Inicializace uzivatelského rozhrani");
     return new AudioPluginAudioProcessorEditor (*this);
 }
 
 void AudioPluginAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    Logger::getInstance().log("AudioPluginAudioProcessor/getStateInformation", "info", "Ukladani stavu pluginu");
-    juce::ignoreUnused (destData);
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/getStateInformation", "Ukladani stavu pluginu");
+
+    PluginState state;
+    state.settings = samplerSettings;
+
+    {
+        const juce::ScopedLock sl (libraryLock);
+        state.libraryFingerprint = sampleLibrary != nullptr ? sampleLibrary->getFingerprint() : 0;
+    }
+
+    state.writeTo(destData);
 }
 
+/**
+ * Obnovení stavu z projektu. Nikdy nečeká na načtení nástroje: shodný nástroj
+ * se ponechá, jinak se načte na pozadí (platná cache se jen namapuje podle
+ * fingerprintu). Engine se přestaví jen při změně počtu hlasů nebo DFD.
+ */
 void AudioPluginAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    Logger::getInstance().log("AudioPluginAudioProcessor/setStateInformation", "info", 
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/setStateInformation", 
         "Nacitani stavu pluginu (velikost: " + juce::String(sizeInBytes) + " bytu)");
-    juce::ignoreUnused (data, sizeInBytes);
+
+    PluginState state;
+    if (! state.readFrom(data, sizeInBytes))
+    {
+        ITHACA_LOG_ERROR("AudioPluginAudioProcessor/setStateInformation", "Stav pluginu nelze precist - ponechano aktualni nastaveni");
+        return;
+    }
+
+    const SamplerSettings previousSettings = samplerSettings;
+    samplerSettings = state.settings;
+    sanitizeSamplerSettings();
+    updateLogJournal();
+    applyRuntimeSettings();
+
+    bool reload = requiresLibraryReload(previousSettings, samplerSettings);
+    {
+        const juce::ScopedLock sl (libraryLock);
+        if (sampleLibrary == nullptr)
+            reload = true;
+        else if (state.libraryFingerprint != 0 && state.libraryFingerprint != sampleLibrary->getFingerprint())
+            reload = true;
+    }
+
+    if (reload)
+    {
+        restoredFingerprint = state.libraryFingerprint;
+        libraryLoader.startLoad(samplerSettings);
+    }
+    else
+    {
+        ITHACA_LOG_INFO("AudioPluginAudioProcessor/setStateInformation", "Nacteny nastroj odpovida ulozenemu stavu - bez znovunacteni");
+    }
+
+    // Bez audia (typicky při otevření projektu) se engine připraví až v prepareToPlay
+    if (getSampleRate() > 0.0 && requiresEnginePrepare(previousSettings, samplerSettings))
+    {
+        suspendProcessing (true);
+        prepareSampler (getSampleRate(), getBlockSize());
+        suspendProcessing (false);
+    }
+}
+
+/**
+ * Kvalita interpolace, crossfade, výběr variant a obálka se přepínají za běhu
+ * (atomicky, bez přestavby enginu a bez utnutí znějících hlasů).
+ */
+void AudioPluginAudioProcessor::applyRuntimeSettings()
+{
+    samplerEngine.setInterpolationQuality(samplerSettings.interpolationQuality);
+    samplerEngine.setVelocityCrossfade(samplerSettings.velocityCrossfade);
+    samplerEngine.setVariantSelection(samplerSettings.variantSelection);
+    samplerEngine.setEnvelope(samplerSettings.attackSeconds, samplerSettings.decaySeconds,
+                              samplerSettings.sustainLevel, samplerSettings.releaseSeconds);
+}
+
+void AudioPluginAudioProcessor::sanitizeSamplerSettings()
+{
+    samplerSettings.maxVoices = juce::jlimit (1, IthacaConfig::MAX_POLYPHONY, samplerSettings.maxVoices);
+    samplerSettings.preloadMilliseconds = juce::jmax (1, samplerSettings.preloadMilliseconds);
+    samplerSettings.numStreamingThreads = juce::jmax (1, samplerSettings.numStreamingThreads);
+    samplerSettings.attackSeconds = juce::jlimit (0.0f, 10.0f, samplerSettings.attackSeconds);
+    samplerSettings.decaySeconds = juce::jlimit (0.0f, 30.0f, samplerSettings.decaySeconds);
+    samplerSettings.sustainLevel = juce::jlimit (0.0f, 1.0f, samplerSettings.sustainLevel);
+    samplerSettings.releaseSeconds = juce::jlimit (0.0f, 30.0f, samplerSettings.releaseSeconds);
+}
+
+/**
+ * Změna nastavení sampleru. Nastavení přepínatelná za běhu se jen předají
+ * enginu; nástroj se znovu načte jen při změně jeho obsahu (adresář, formát,
+ * DFD...) a engine se přestaví (utne hlasy, audio pozastaveno) jen při změně
+ * rozložení hlasů a DFD slotů - stejně jako při obnovení stavu.
+ */
+void AudioPluginAudioProcessor::setSamplerSettings (const SamplerSettings& newSettings)
+{
+    const SamplerSettings previousSettings = samplerSettings;
+    samplerSettings = newSettings;
+    sanitizeSamplerSettings();
+    updateLogJournal();
+    applyRuntimeSettings();
+
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/setSamplerSettings", 
+        "Nove nastaveni sampleru - DFD: " + juce::String(samplerSettings.streamFromDisk ? "ANO" : "NE")
+        + ", preload: " + juce::String(samplerSettings.preloadMilliseconds) + " ms"
+        + ", stream buffer: " + juce::String(samplerSettings.streamBufferFrames) + " frames");
+
+    bool reload = requiresLibraryReload (previousSettings, samplerSettings);
+    {
+        const juce::ScopedLock sl (libraryLock);
+        reload = reload || (sampleLibrary == nullptr && ! libraryLoader.isLoading());
+    }
+
+    // Dosavadní nástroj hraje dál, dokud ho nový z loaderu nenahradí
+    if (reload)
+        libraryLoader.startLoad (samplerSettings);
+
+    // Přestavba hlasů a slotů je krátká
+    if (getSampleRate() > 0.0 && requiresEnginePrepare (previousSettings, samplerSettings))
+    {
+        suspendProcessing (true);
+        prepareSampler (getSampleRate(), getBlockSize());
+        suspendProcessing (false);
+    }
+}
+
+void AudioPluginAudioProcessor::setLogJournalEnabled (bool shouldWrite)
+{
+    samplerSettings.writeLogJournal = shouldWrite;
+    updateLogJournal();
+}
+
+/**
+ * Přihlášení / odhlášení instance u sdíleného journalu podle nastavení.
+ * Journal zapisuje, dokud ho chce aspoň jedna instance.
+ */
+void AudioPluginAudioProcessor::updateLogJournal()
+{
+    if (samplerSettings.writeLogJournal == writesLogJournal)
+        return;
+
+    writesLogJournal = samplerSettings.writeLogJournal;
+
+    if (writesLogJournal)
+        logJournal->addWriter();
+    else
+        logJournal->removeWriter();
+
+    ITHACA_LOG_INFO("AudioPluginAudioProcessor/updateLogJournal",
+        "Journal logu " + juce::String(writesLogJournal ? "ZAPNUT" : "VYPNUT") + ": " + logJournal->getDirectory().getFullPathName());
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -1,7 +1,14 @@
 #pragma once
 
 #include <juce_audio_processors/juce_audio_processors.h>
+#include "LogJournal.h"
 #include "Logger.h"
+#include "PerformanceMonitor.h"
+#include "PluginState.h"
+#include "RtLogger.h"
+#include "SampleLibrary.h"
+#include "SampleLibraryLoader.h"
+#include "SamplerEngine.h"
 
 //==============================================================================
 class AudioPluginAudioProcessor final : public juce::AudioProcessor
@@ -43,10 +50,68 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    //==============================================================================
+    // Nastavení sampleru (DFD režim, preload, velikost stream bufferu...)
+    const SamplerSettings& getSamplerSettings() const noexcept { return samplerSettings; }
+    void setSamplerSettings (const SamplerSettings& newSettings);
+
+    // Zápis logu na disk (SamplerSettings::writeLogJournal) - bez přestavby enginu
+    void setLogJournalEnabled (bool shouldWrite);
+
+    // Průběh načítání nástroje na pozadí (editor ho periodicky čte)
+    SampleLibraryLoader::Progress getLibraryLoadProgress() const noexcept { return libraryLoader.getProgress(); }
+    void cancelLibraryLoad() { libraryLoader.cancel(); }
+
+    // Čekání na dokončení načítání (headless nástroje, nikdy z audio vlákna); false = timeout
+    bool waitUntilLibraryLoaded (int timeoutMs) const { return libraryLoader.waitUntilIdle (timeoutMs); }
+
+    // Počet podtečení DFD streamu od startu
+    juce::uint64 getStreamUnderrunCount() const noexcept { return samplerEngine.getStreamUnderrunCount(); }
+
+    // Metriky audio vlákna (čtení nikdy neblokuje processBlock)
+    PerformanceMonitor& getPerformanceMonitor() noexcept { return performanceMonitor; }
+    const PerformanceMonitor& getPerformanceMonitor() const noexcept { return performanceMonitor; }
+
 private:
+    void prepareSampler (double sampleRate, int samplesPerBlock);
+    void onLibraryLoaded (std::unique_ptr<SampleLibrary> newLibrary);
+    void releaseRetiredLibraries (int timeoutMs);
+    void sanitizeSamplerSettings();
+    void applyRuntimeSettings();
+    void updateLogJournal();
+
     // Sledování, zda byla alokována konzole
     bool consoleAllocated;
 
+    // Nastavení sampleru
+    SamplerSettings samplerSettings;
+
+    // Nahraný nástroj a hlasový engine. libraryLock chrání vlastnictví nástrojů
+    // (message a loader vlákno); audio vlákno ho nikdy nebere.
+    juce::CriticalSection libraryLock;
+    std::unique_ptr<SampleLibrary> sampleLibrary;
+    std::vector<std::unique_ptr<SampleLibrary>> retiredLibraries;   // Čekají, až je engine přestane používat
+    std::atomic<juce::uint64> restoredFingerprint { 0 };             // Fingerprint nástroje z uloženého stavu (kontrola po načtení)
+    SamplerEngine samplerEngine;
+
+    // Načítání nástroje na pozadí (ničí se první, před enginem a nástroji)
+    SampleLibraryLoader libraryLoader { [this] (std::unique_ptr<SampleLibrary> library) { onLibraryLoaded (std::move (library)); } };
+
+    // Doba bloku, zátěž vůči deadlinu, hlasy a MIDI (zapisuje audio vlákno)
+    PerformanceMonitor performanceMonitor;
+
+    // Real-time logovací kanál pro audio vlákno (drainer formátuje mimo audio vlákno)
+    RtLogger rtLogger;
+
+    // Journal logu na disk - jeden pro všechny instance pluginu (Logger je singleton)
+    juce::SharedResourcePointer<LogJournal> logJournal;
+    bool writesLogJournal = false;          // Tato instance je mezi zapisovateli journalu
+
+    // Čítače audio vlákna (timestamp ve vzorcích, statistiky pro log)
+    int64_t processedSamples = 0;
+    int processCount = 0;
+    int totalMidiEvents = 0;
+
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioPluginAudioProcessor)
 };
\ No newline at end of file
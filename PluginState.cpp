@@ -0,0 +1,211 @@
+#include "PluginState.h"
+#include "Logger.h"
+
+namespace
+{
+    constexpr int stateMagic = 0x53485449;     // "ITHS" v little-endian
+    constexpr int headerSize = 3 * (int) sizeof (juce::int32);
+    const char* const xmlTag = "IthacaPlayerState";
+
+    InterpolationQuality toInterpolationQuality (int value) noexcept
+    {
+        return (InterpolationQuality) juce::jlimit ((int) InterpolationQuality::Linear, (int) InterpolationQuality::Sinc16, value);
+    }
+
+    VoiceAllocator::StealPolicy toStealPolicy (int value) noexcept
+    {
+        return (VoiceAllocator::StealPolicy) juce::jlimit ((int) VoiceAllocator::StealPolicy::Oldest,
+                                                           (int) VoiceAllocator::StealPolicy::ReleasePhaseFirst, value);
+    }
+
+    VariantSelection toVariantSelection (int value) noexcept
+    {
+        return (VariantSelection) juce::jlimit ((int) VariantSelection::RoundRobin, (int) VariantSelection::Random, value);
+    }
+
+    SampleStorage toSampleStorage (int value) noexcept
+    {
+        return (SampleStorage) juce::jlimit ((int) SampleStorage::Float32, (int) SampleStorage::Compressed, value);
+    }
+
+    // Do verze 4 byl místo formátu jen přepínač compactSampleCache (vypnuto = plná přesnost, tj. Native)
+    SampleStorage fromCompactFlag (bool compact) noexcept
+    {
+        return compact ? SampleStorage::Compact16 : SampleStorage::Native;
+    }
+}
+
+/**
+ * Hlavička, binární pole a za nimi XML kopie stavu (fallback pro jiné verze).
+ */
+void PluginState::writeTo (juce::MemoryBlock& destData) const
+{
+    juce::MemoryOutputStream binary;
+    binary.writeString (settings.sampleDirectory.getFullPathName());
+    binary.writeInt (settings.maxVoices);
+    binary.writeByte ((char) settings.stealPolicy);
+    binary.writeByte ((char) settings.interpolationQuality);
+    binary.writeBool (settings.generateMissingNotes);
+    binary.writeBool (settings.useSampleCache);
+    binary.writeByte ((char) settings.sampleStorage);
+    binary.writeBool (settings.streamFromDisk);
+    binary.writeInt (settings.preloadMilliseconds);
+    binary.writeInt (settings.streamBufferFrames);
+    binary.writeInt (settings.numStreamingThreads);
+    binary.writeInt64 ((juce::int64) libraryFingerprint);
+    binary.writeBool (settings.velocityCrossfade);
+    binary.writeByte ((char) settings.variantSelection);
+    binary.writeFloat (settings.attackSeconds);
+    binary.writeFloat (settings.decaySeconds);
+    binary.writeFloat (settings.sustainLevel);
+    binary.writeFloat (settings.releaseSeconds);
+    binary.writeBool (settings.writeLogJournal);
+
+    juce::MemoryOutputStream out (destData, false);
+    out.writeInt (stateMagic);
+    out.writeInt ((int) formatVersion);
+    out.writeInt ((int) binary.getDataSize());
+    out.write (binary.getData(), binary.getDataSize());
+    out.writeString (toXml()->toString());
+}
+
+bool PluginState::readFrom (const void* data, int sizeInBytes)
+{
+    if (data == nullptr || sizeInBytes <= 0)
+        return false;
+
+    juce::MemoryInputStream in (data, (size_t) sizeInBytes, false);
+
+    // Bez hlavičky - celý blok jako XML text
+    if (sizeInBytes < headerSize || in.readInt() != stateMagic)
+    {
+        auto xml = juce::parseXML (juce::String::fromUTF8 (static_cast<const char*> (data), sizeInBytes));
+        return xml != nullptr && fromXml (*xml);
+    }
+
+    const int version = in.readInt();
+    const int binarySize = in.readInt();
+
+    if (binarySize < 0 || binarySize > in.getNumBytesRemaining())
+    {
+        ITHACA_LOG_ERROR ("PluginState/readFrom", "Poskozena hlavicka stavu (binarni cast " + juce::String (binarySize) + " B)");
+        return false;
+    }
+
+    // Novější verze - binární část se přeskočí a použije se XML kopie
+    if (version <= 0 || version > (int) formatVersion)
+    {
+        in.skipNextBytes (binarySize);
+        auto xml = juce::parseXML (in.readString());
+
+        ITHACA_LOG_WARN ("PluginState/readFrom", 
+            "Neznama verze stavu " + juce::String (version) + ", pouzit XML fallback");
+
+        return xml != nullptr && fromXml (*xml);
+    }
+
+    PluginState restored;
+    restored.settings.sampleDirectory = juce::File (in.readString());
+    restored.settings.maxVoices = in.readInt();
+    restored.settings.stealPolicy = toStealPolicy ((juce::uint8) in.readByte());
+    restored.settings.interpolationQuality = toInterpolationQuality ((juce::uint8) in.readByte());
+    restored.settings.generateMissingNotes = in.readBool();
+    restored.settings.useSampleCache = in.readBool();
+    const auto storage = (juce::uint8) in.readByte();
+    restored.settings.sampleStorage = version >= 5 ? toSampleStorage (storage) : fromCompactFlag (storage != 0);
+    restored.settings.streamFromDisk = in.readBool();
+    restored.settings.preloadMilliseconds = in.readInt();
+    restored.settings.streamBufferFrames = in.readInt();
+    restored.settings.numStreamingThreads = in.readInt();
+    restored.libraryFingerprint = (juce::uint64) in.readInt64();
+
+    if (version >= 2)
+        restored.settings.velocityCrossfade = in.readBool();
+
+    if (version >= 3)
+        restored.settings.variantSelection = toVariantSelection ((juce::uint8) in.readByte());
+
+    if (version >= 4)
+    {
+        restored.settings.attackSeconds = in.readFloat();
+        restored.settings.decaySeconds = in.readFloat();
+        restored.settings.sustainLevel = in.readFloat();
+        restored.settings.releaseSeconds = in.readFloat();
+    }
+
+    if (version >= 6)
+        restored.settings.writeLogJournal = in.readBool();
+
+    if (in.getPosition() != headerSize + binarySize)
+    {
+        ITHACA_LOG_ERROR ("PluginState/readFrom", "Binarni cast stavu neodpovida verzi " + juce::String (version));
+        return false;
+    }
+
+    *this = restored;
+    return true;
+}
+
+std::unique_ptr<juce::XmlElement> PluginState::toXml() const
+{
+    auto xml = std::make_unique<juce::XmlElement> (xmlTag);
+    xml->setAttribute ("version", (int) formatVersion);
+    xml->setAttribute ("sampleDirectory", settings.sampleDirectory.getFullPathName());
+    xml->setAttribute ("maxVoices", settings.maxVoices);
+    xml->setAttribute ("stealPolicy", (int) settings.stealPolicy);
+    xml->setAttribute ("interpolationQuality", (int) settings.interpolationQuality);
+    xml->setAttribute ("generateMissingNotes", settings.generateMissingNotes ? 1 : 0);
+    xml->setAttribute ("useSampleCache", settings.useSampleCache ? 1 : 0);
+    xml->setAttribute ("sampleStorage", (int) settings.sampleStorage);
+    xml->setAttribute ("streamFromDisk", settings.streamFromDisk ? 1 : 0);
+    xml->setAttribute ("preloadMilliseconds", settings.preloadMilliseconds);
+    xml->setAttribute ("streamBufferFrames", settings.streamBufferFrames);
+    xml->setAttribute ("numStreamingThreads", settings.numStreamingThreads);
+    xml->setAttribute ("velocityCrossfade", settings.velocityCrossfade ? 1 : 0);
+    xml->setAttribute ("variantSelection", (int) settings.variantSelection);
+    xml->setAttribute ("attackSeconds", settings.attackSeconds);
+    xml->setAttribute ("decaySeconds", settings.decaySeconds);
+    xml->setAttribute ("sustainLevel", settings.sustainLevel);
+    xml->setAttribute ("releaseSeconds", settings.releaseSeconds);
+    xml->setAttribute ("writeLogJournal", settings.writeLogJournal ? 1 : 0);
+    xml->setAttribute ("libraryFingerprint", juce::String::toHexString ((juce::int64) libraryFingerprint));
+    return xml;
+}
+
+/**
+ * Chybějící atributy si ponechají výchozí hodnoty SamplerSettings.
+ */
+bool PluginState::fromXml (const juce::XmlElement& xml)
+{
+    if (! xml.hasTagName (xmlTag))
+        return false;
+
+    PluginState restored;
+    auto& s = restored.settings;
+
+    if (xml.hasAttribute ("sampleDirectory"))
+        s.sampleDirectory = juce::File (xml.getStringAttribute ("sampleDirectory"));
+
+    s.maxVoices = xml.getIntAttribute ("maxVoices", s.maxVoices);
+    s.stealPolicy = toStealPolicy (xml.getIntAttribute ("stealPolicy", (int) s.stealPolicy));
+    s.interpolationQuality = toInterpolationQuality (xml.getIntAttribute ("interpolationQuality", (int) s.interpolationQuality));
+    s.generateMissingNotes = xml.getBoolAttribute ("generateMissingNotes", s.generateMissingNotes);
+    s.useSampleCache = xml.getBoolAttribute ("useSampleCache", s.useSampleCache);
+    s.sampleStorage = xml.hasAttribute ("sampleStorage") ? toSampleStorage (xml.getIntAttribute ("sampleStorage"))
+                                                         : fromCompactFlag (xml.getBoolAttribute ("compactSampleCache"));
+    s.streamFromDisk = xml.getBoolAttribute ("streamFromDisk", s.streamFromDisk);
+    s.preloadMilliseconds = xml.getIntAttribute ("preloadMilliseconds", s.preloadMilliseconds);
+    s.streamBufferFrames = xml.getIntAttribute ("streamBufferFrames", s.streamBufferFrames);
+    s.numStreamingThreads = xml.getIntAttribute ("numStreamingThreads", s.numStreamingThreads);
+    s.velocityCrossfade = xml.getBoolAttribute ("velocityCrossfade", s.velocityCrossfade);
+    s.variantSelection = toVariantSelection (xml.getIntAttribute ("variantSelection", (int) s.variantSelection));
+    s.attackSeconds = (float) xml.getDoubleAttribute ("attackSeconds", s.attackSeconds);
+    s.decaySeconds = (float) xml.getDoubleAttribute ("decaySeconds", s.decaySeconds);
+    s.sustainLevel = (float) xml.getDoubleAttribute ("sustainLevel", s.sustainLevel);
+    s.releaseSeconds = (float) xml.getDoubleAttribute ("releaseSeconds", s.releaseSeconds);
+    s.writeLogJournal = xml.getBoolAttribute ("writeLogJournal", s.writeLogJournal);
+    restored.libraryFingerprint = (juce::uint64) xml.getStringAttribute ("libraryFingerprint").getHexValue64();
+
+    *this = restored;
+    return true;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <memory>
+#include "SamplerSettings.h"
+
+/**
+ * Struktura PluginState - uložený stav pluginu v projektu hostitele.
+ *
+ * Obsahuje nastavení sampleru a fingerprint nástroje, který byl při uložení
+ * načtený. Binární formát je verzovaný:
+ *
+ *   [magic "ITHS"][verze][velikost binární části][binární pole ...][XML]
+ *
+ * Za binární částí následuje stejný stav jako XML text. Starší verze pluginu,
+ * která binární verzi nezná, přečte XML podle názvů atributů a neznámé
+ * hodnoty vynechá. Data bez hlavičky se zkusí přečíst celá jako XML
+ * (ručně upravený nebo externě vytvořený stav).
+ */
+struct PluginState
+{
+    static constexpr juce::uint32 formatVersion = 6;      // 2: velocityCrossfade, 3: variantSelection, 4: ADSR, 5: sampleStorage, 6: writeLogJournal
+
+    SamplerSettings settings;
+    juce::uint64 libraryFingerprint = 0;    // 0 = žádný nástroj nebyl načten
+
+    void writeTo (juce::MemoryBlock& destData) const;
+
+    // false = neznámý nebo poškozený stav (struktura zůstane beze změny)
+    bool readFrom (const void* data, int sizeInBytes);
+
+    std::unique_ptr<juce::XmlElement> toXml() const;
+    bool fromXml (const juce::XmlElement& xml);
+};
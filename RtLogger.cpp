@@ -0,0 +1,173 @@
+#include "RtLogger.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+
+namespace
+{
+    // Formátovací šablony indexované RtLogEvent (pořadí musí odpovídat enumu)
+    const char* const eventFormats[] =
+    {
+        "Audio blok #%0 - velikost: %1 samples, kanaly: %2",          // BlockInfo
+        "Maximalni amplituda v bloku: %0",                             // BlockMaxAmplitude
+        "Zpracovano %0 audio bloku, celkem MIDI: %1",                  // BlockProgress
+        "=== MIDI UDALOSTI ===",                                        // MidiBlockStart
+        "MIDI #%0 @ sample %1: NOTE ON - Note: %2 (%N2), Velocity: %3", // MidiNoteOn
+        "MIDI #%0 @ sample %1: NOTE OFF - Note: %2 (%N2), Velocity: %3",// MidiNoteOff
+        "MIDI #%0 @ sample %1: CC - Controller: %2, Value: %3",        // MidiController
+        "MIDI #%0 @ sample %1: PITCH BEND - Value: %2",                 // MidiPitchBend
+        "MIDI #%0 @ sample %1: PROGRAM CHANGE - Program: %2",           // MidiProgramChange
+        "MIDI #%0 @ sample %1: CHANNEL PRESSURE - Pressure: %2",        // MidiChannelPressure
+        "MIDI #%0 @ sample %1: AFTERTOUCH - Note: %2, Pressure: %3",    // MidiAftertouch
+        "MIDI #%0 @ sample %1: OTHER - Status: %2, Velikost: %3 bytu",  // MidiOther
+        "Celkem MIDI udalosti v bloku: %0"                              // MidiBlockSummary
+    };
+
+    static_assert (juce::numElementsInArray (eventFormats) == (int) RtLogEvent::NumEvents,
+                   "Tabulka eventFormats neodpovida RtLogEvent");
+
+    const char* const componentNames[] =
+    {
+        "AudioPluginAudioProcessor/processBlock"                        // ProcessBlock
+    };
+
+    static_assert (juce::numElementsInArray (componentNames) == (int) RtLogComponent::NumComponents,
+                   "Tabulka componentNames neodpovida RtLogComponent");
+
+    juce::String formatArg (double value)
+    {
+        // Celá čísla bez desetinné části, ostatní s 6 desetinnými místy
+        if (value == std::floor (value) && std::abs (value) < 1.0e15)
+            return juce::String ((juce::int64) value);
+
+        return juce::String (value, 6);
+    }
+}
+
+//==============================================================================
+RtLogger::RtLogger (int capacity)
+    : ring ((size_t) juce::nextPowerOfTwo (juce::jmax (2, capacity))),
+      mask (ring.size() - 1)
+{
+}
+
+RtLogger::~RtLogger()
+{
+    stopDrainer();
+}
+
+void RtLogger::startDrainer()
+{
+    if (! drainer.isThreadRunning())
+        drainer.startThread (juce::Thread::Priority::low);
+}
+
+void RtLogger::stopDrainer()
+{
+    drainer.stopThread (2000);
+
+    // Doformátování zbytku, aby se neztratily poslední záznamy
+    drain();
+}
+
+/**
+ * Zápis do ringu - volá pouze producent (audio vlákno).
+ */
+bool RtLogger::push (const RtLogRecord& record) noexcept
+{
+    const auto write = writeIndex.load (std::memory_order_relaxed);
+    const auto read = readIndex.load (std::memory_order_acquire);
+
+    if (write - read >= ring.size())
+    {
+        droppedCount.fetch_add (1, std::memory_order_relaxed);
+        return false;
+    }
+
+    ring[write & mask] = record;
+    writeIndex.store (write + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * Čtení z ringu - volá pouze konzument (drainer).
+ */
+bool RtLogger::pop (RtLogRecord& record) noexcept
+{
+    const auto read = readIndex.load (std::memory_order_relaxed);
+    const auto write = writeIndex.load (std::memory_order_acquire);
+
+    if (read == write)
+        return false;
+
+    record = ring[read & mask];
+    readIndex.store (read + 1, std::memory_order_release);
+    return true;
+}
+
+int RtLogger::drain()
+{
+    int drained = 0;
+    RtLogRecord record;
+
+    while (pop (record))
+    {
+        // Úroveň se mohla od zápisu změnit - formátuje se jen to, co projde filtrem
+        ITHACA_LOG (record.severity, getComponentName (record.component), formatRecord (record));
+        ++drained;
+    }
+
+    return drained;
+}
+
+/**
+ * Převod binárního záznamu na text podle šablony události.
+ */
+juce::String RtLogger::formatRecord (const RtLogRecord& record)
+{
+    const auto eventIndex = (int) record.event;
+    const char* format = juce::isPositiveAndBelow (eventIndex, (int) RtLogEvent::NumEvents)
+                             ? eventFormats[eventIndex] : "Neznama udalost";
+
+    juce::String text;
+    text.preallocateBytes (128);
+    text << "[smp " << juce::String ((juce::int64) record.samplePosition) << "] ";
+
+    for (const char* p = format; *p != 0; ++p)
+    {
+        const bool isNoteName = (p[0] == '%' && p[1] == 'N' && p[2] >= '0' && p[2] <= '9');
+        const bool isArg = (p[0] == '%' && p[1] >= '0' && p[1] <= '9');
+
+        if (isNoteName || isArg)
+        {
+            const int argIndex = (isNoteName ? p[2] : p[1]) - '0';
+            const double value = argIndex < record.numArgs ? record.args[argIndex] : 0.0;
+
+            if (isNoteName)
+                text << juce::MidiMessage::getMidiNoteName ((int) value, true, true, 4);
+            else
+                text << formatArg (value);
+
+            p += isNoteName ? 2 : 1;
+            continue;
+        }
+
+        text << juce::String::charToString ((juce::juce_wchar) (juce::uint8) *p);
+    }
+
+    return text;
+}
+
+const char* RtLogger::getComponentName (RtLogComponent component)
+{
+    const auto index = (int) component;
+    return juce::isPositiveAndBelow (index, (int) RtLogComponent::NumComponents) ? componentNames[index] : "Unknown";
+}
+
+//==============================================================================
+void RtLogger::DrainerThread::run()
+{
+    while (! threadShouldExit())
+    {
+        owner.drain();
+        wait (drainIntervalMs);
+    }
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "Logger.h"
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Identifikátor komponenty, která záznam vytvořila.
+ * Audio vlákno neposílá stringy, jen toto číslo; jméno doplní drainer.
+ */
+enum class RtLogComponent : uint16_t
+{
+    ProcessBlock = 0,
+    NumComponents
+};
+
+/**
+ * Identifikátor zprávy - index do tabulky formátovacích šablon (viz RtLogger.cpp).
+ * Šablona obsahuje zástupné symboly %0..%3 pro číselné argumenty
+ * a %N0..%N3 pro jméno MIDI noty z daného argumentu.
+ */
+enum class RtLogEvent : uint16_t
+{
+    BlockInfo = 0,
+    BlockMaxAmplitude,
+    BlockProgress,
+    MidiBlockStart,
+    MidiNoteOn,
+    MidiNoteOff,
+    MidiController,
+    MidiPitchBend,
+    MidiProgramChange,
+    MidiChannelPressure,
+    MidiAftertouch,
+    MidiOther,
+    MidiBlockSummary,
+    NumEvents
+};
+
+/**
+ * Binární logovací záznam pevné velikosti.
+ * Neobsahuje žádné ukazatele na haldu, takže se dá kopírovat do ringu bez alokací.
+ */
+struct RtLogRecord
+{
+    static constexpr int maxArgs = 4;
+
+    int64_t samplePosition = 0;     // Časová značka ve vzorcích od startu procesoru
+    RtLogComponent component = RtLogComponent::ProcessBlock;
+    RtLogEvent event = RtLogEvent::BlockInfo;
+    LogSeverity severity = LogSeverity::Info;
+    uint8_t numArgs = 0;
+    double args[maxArgs] = {};
+};
+
+/**
+ * Třída RtLogger - real-time logovací kanál pro audio vlákno.
+ *
+ * Audio vlákno (jediný producent) zapisuje binární záznamy do předalokovaného
+ * SPSC ringu - bez alokací, zámků a formátování. Drainer vlákno na pozadí
+ * (jediný konzument) záznamy periodicky vybírá, formátuje a předává
+ * do Logger::log, odkud se dostanou do LogStore a do editoru.
+ *
+ * Pokud je ring plný, záznam se zahodí a zvýší se počítadlo zahozených záznamů;
+ * audio vlákno nikdy nečeká.
+ */
+class RtLogger
+{
+public:
+    static constexpr int defaultCapacity = 4096;   // Musí být mocnina dvou
+    static constexpr int drainIntervalMs = 20;
+
+    explicit RtLogger (int capacity = defaultCapacity);
+    ~RtLogger();
+
+    // Spuštění/zastavení drainer vlákna (volat mimo audio vlákno)
+    void startDrainer();
+    void stopDrainer();
+
+    /**
+     * Zápis záznamu z audio vlákna. Wait-free, bez alokací.
+     * Vrací false, pokud severity neprojde filtrem Loggeru nebo je ring plný.
+     */
+    template <typename... Args>
+    bool log (RtLogComponent component, LogSeverity severity, RtLogEvent event,
+              int64_t samplePosition, Args... args) noexcept
+    {
+        static_assert (sizeof... (Args) <= RtLogRecord::maxArgs, "Prilis mnoho argumentu pro RtLogRecord");
+        static_assert ((std::is_arithmetic_v<Args> && ...), "RtLogger prijima pouze ciselne argumenty");
+
+        if (! Logger::isEnabled (severity))
+            return false;
+
+        RtLogRecord record;
+        record.samplePosition = samplePosition;
+        record.component = component;
+        record.event = event;
+        record.severity = severity;
+        record.numArgs = (uint8_t) sizeof... (Args);
+
+        int index = 0;
+        ((record.args[index++] = static_cast<double> (args)), ...);
+        juce::ignoreUnused (index);
+
+        return push (record);
+    }
+
+    // Počet záznamů zahozených kvůli plnému ringu
+    uint64_t getDroppedCount() const noexcept { return droppedCount.load (std::memory_order_relaxed); }
+
+    // Vybrání a zformátování všech čekajících záznamů (volá drainer, případně test/CLI)
+    int drain();
+
+    // Převod záznamu na text (bez timestampu Loggeru)
+    static juce::String formatRecord (const RtLogRecord& record);
+
+    static const char* getComponentName (RtLogComponent component);
+
+private:
+    bool push (const RtLogRecord& record) noexcept;
+    bool pop (RtLogRecord& record) noexcept;
+
+    class DrainerThread : public juce::Thread
+    {
+    public:
+        explicit DrainerThread (RtLogger& o) : juce::Thread ("IthacaPlayer RtLogger"), owner (o) {}
+        void run() override;
+
+    private:
+        RtLogger& owner;
+    };
+
+    std::vector<RtLogRecord> ring;
+    const size_t mask;
+
+    // Zápisový index vlastní producent, čtecí konzument; oddělené cache line
+    alignas (64) std::atomic<size_t> writeIndex { 0 };
+    alignas (64) std::atomic<size_t> readIndex { 0 };
+    alignas (64) std::atomic<uint64_t> droppedCount { 0 };
+
+    DrainerThread drainer { *this };
+
+    JUCE_DECLARE_NON_COPYABLE (RtLogger)
+};
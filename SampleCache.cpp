@@ -0,0 +1,291 @@
+#include "SampleCache.h"
+#include "SampleCodec.h"
+#include "Logger.h"
+
+namespace
+{
+    const char cacheMagic[8] = { 'I', 'T', 'H', 'C', 'A', 'C', 'H', 'E' };
+}
+
+juce::uint64 SampleCache::alignOffset (juce::uint64 offset) noexcept
+{
+    return (offset + dataAlignment - 1) & ~(juce::uint64) (dataAlignment - 1);
+}
+
+juce::File SampleCache::getCacheFileFor (const juce::File& sampleDirectory)
+{
+    return IthacaConfig::getCacheDirectory()
+               .getChildFile ("library_" + juce::String::toHexString (sampleDirectory.getFullPathName().hashCode64()) + ".ithpack");
+}
+
+size_t SampleCache::getMappedSize() const noexcept
+{
+    return mappedFile != nullptr ? mappedFile->getSize() : 0;
+}
+
+//==============================================================================
+/**
+ * Zápis kontejneru: hlavička, index, zarovnaná planární PCM data.
+ * Celočíselné a komprimované vzorky se zapíší beze změny, float vzorky ve floatFormat.
+ */
+bool SampleCache::write (const juce::File& file, const std::vector<const SampleData*>& samples,
+                         juce::uint64 fingerprint, SampleFormat floatFormat)
+{
+    Header header {};
+    std::memcpy (header.magic, cacheMagic, sizeof (header.magic));
+    header.version = formatVersion;
+    header.numEntries = (juce::uint32) samples.size();
+    header.dataAlignment = dataAlignment;
+    header.fingerprint = fingerprint;
+    header.indexOffset = sizeof (Header);
+
+    // Tabulka názvů zdrojových souborů hned za indexem
+    const auto namesOffset = header.indexOffset + sizeof (IndexEntry) * samples.size();
+    juce::MemoryBlock names;
+    for (const auto* sample : samples)
+        names.append (sample->file.getFileName().toRawUTF8(), sample->file.getFileName().getNumBytesAsUTF8());
+
+    header.dataOffset = alignOffset (namesOffset + names.getSize());
+
+    // Sestavení indexu a rozvržení dat
+    std::vector<IndexEntry> entries;
+    entries.reserve (samples.size());
+    auto offset = header.dataOffset;
+    auto nameOffset = namesOffset;
+
+    for (const auto* sample : samples)
+    {
+        // Do cache jdou jen plně rezidentní vzorky
+        jassert (! sample->isStreamed());
+
+        const auto format = sample->format == SampleFormat::Float32 ? floatFormat : sample->format;
+        const bool compressed = format == SampleFormat::Compressed;
+
+        IndexEntry entry {};
+        entry.midiNote = (juce::int16) sample->midiNote;
+        entry.dbLevel = (juce::int16) sample->dbLevel;
+        entry.variant = (juce::int16) sample->variant;
+        entry.numChannels = (juce::uint8) sample->getNumChannels();
+        entry.format = (juce::uint8) format;
+        entry.numFrames = (juce::uint32) sample->numFrames;
+        entry.scale = sample->format == SampleFormat::Float32 ? 1.0f : sample->scale;
+        entry.sampleRate = sample->sampleRate;
+        entry.dataOffset = offset;
+        entry.channelStride = compressed ? alignOffset (SampleCodec::getEncodedSize (sample->channelData[0]))
+                                         : alignOffset ((juce::uint64) (sample->numFrames + 1) * getBytesPerSample (format));
+        entry.nameOffset = (juce::uint32) nameOffset;
+        entry.nameLength = (juce::uint32) sample->file.getFileName().getNumBytesAsUTF8();
+        nameOffset += entry.nameLength;
+
+        if (format != sample->format)
+        {
+            float peak = 0.0f;
+            for (int channel = 0; channel < sample->getNumChannels(); ++channel)
+            {
+                const auto* data = sample->getChannel<float> (channel);
+                for (int i = 0; i < sample->numFrames; ++i)
+                    peak = juce::jmax (peak, std::abs (data[i]));
+            }
+
+            entry.scale = peak > 0.0f ? peak / 32767.0f : 1.0f;
+        }
+
+        // Komprimovaný vzorek má oba kanály v jednom bloku dat
+        offset += entry.channelStride * (compressed ? 1u : entry.numChannels);
+        entries.push_back (entry);
+    }
+
+    if (! file.getParentDirectory().createDirectory())
+        return false;
+
+    auto tempFile = file.getSiblingFile (file.getFileName() + ".tmp");
+    tempFile.deleteFile();
+
+    {
+        juce::FileOutputStream out (tempFile);
+        if (! out.openedOk())
+            return false;
+
+        out.write (&header, sizeof (header));
+        out.write (entries.data(), sizeof (IndexEntry) * entries.size());
+        out.write (names.getData(), names.getSize());
+        out.writeRepeatedByte (0, (size_t) (header.dataOffset - (juce::uint64) out.getPosition()));
+
+        std::vector<juce::int16> converted;
+
+        for (size_t i = 0; i < samples.size(); ++i)
+        {
+            const auto* sample = samples[i];
+            const auto& entry = entries[i];
+
+            if ((SampleFormat) entry.format == SampleFormat::Compressed)
+            {
+                const auto encodedBytes = SampleCodec::getEncodedSize (sample->channelData[0]);
+                out.write (sample->channelData[0], encodedBytes);
+                out.writeRepeatedByte (0, (size_t) entry.channelStride - encodedBytes);
+                continue;
+            }
+
+            const auto channelBytes = (size_t) (sample->numFrames + 1) * getBytesPerSample ((SampleFormat) entry.format);
+
+            for (int channel = 0; channel < entry.numChannels; ++channel)
+            {
+                if ((SampleFormat) entry.format != sample->format)
+                {
+                    // Float -> int16 se scale podle špičky vzorku
+                    const auto* data = sample->getChannel<float> (channel);
+                    converted.resize ((size_t) sample->numFrames + 1);
+                    for (size_t f = 0; f < converted.size(); ++f)
+                        converted[f] = (juce::int16) juce::jlimit (-32767, 32767, juce::roundToInt (data[f] / entry.scale));
+
+                    out.write (converted.data(), channelBytes);
+                }
+                else
+                {
+                    // Včetně nulového guard frame
+                    out.write (sample->getChannel<char> (channel), channelBytes);
+                }
+
+                out.writeRepeatedByte (0, (size_t) entry.channelStride - channelBytes);
+            }
+        }
+
+        out.flush();
+
+        if (out.getStatus().failed())
+        {
+            ITHACA_LOG_ERROR ("SampleCache/write", 
+                "Chyba zapisu cache: " + out.getStatus().getErrorMessage());
+            return false;
+        }
+    }
+
+    if (! tempFile.moveFileTo (file))
+    {
+        tempFile.deleteFile();
+        return false;
+    }
+
+    ITHACA_LOG_INFO ("SampleCache/write", 
+        "Cache zapsana: " + file.getFullPathName() + " (" + juce::String ((int) samples.size()) + " vzorku, "
+        + juce::String ((double) offset / (1024.0 * 1024.0), 1) + " MB)");
+    return true;
+}
+
+/**
+ * Namapování souboru a kontrola hlavičky a všech položek indexu.
+ */
+bool SampleCache::open (const juce::File& file, juce::uint64 expectedFingerprint)
+{
+    mappedFile.reset();
+    mappedBase = nullptr;
+    index = nullptr;
+    numEntries = 0;
+
+    if (! file.existsAsFile())
+        return false;
+
+    auto mapping = std::make_unique<juce::MemoryMappedFile> (file, juce::MemoryMappedFile::readOnly);
+    const auto* base = static_cast<const char*> (mapping->getData());
+    const auto size = (juce::uint64) mapping->getSize();
+
+    if (base == nullptr || size < sizeof (Header))
+        return false;
+
+    Header header;
+    std::memcpy (&header, base, sizeof (header));
+
+    if (std::memcmp (header.magic, cacheMagic, sizeof (header.magic)) != 0
+        || header.version != formatVersion
+        || header.dataAlignment != dataAlignment)
+    {
+        ITHACA_LOG_WARN ("SampleCache/open", "Neplatna hlavicka cache: " + file.getFileName());
+        return false;
+    }
+
+    if (header.fingerprint != expectedFingerprint)
+    {
+        ITHACA_LOG_INFO ("SampleCache/open", "Cache neodpovida adresari vzorku (zmena souboru)");
+        return false;
+    }
+
+    if (header.indexOffset % alignof (IndexEntry) != 0
+        || header.indexOffset + (juce::uint64) header.numEntries * sizeof (IndexEntry) > size)
+    {
+        ITHACA_LOG_WARN ("SampleCache/open", "Poskozeny index cache: " + file.getFileName());
+        return false;
+    }
+
+    const auto* entries = reinterpret_cast<const IndexEntry*> (base + header.indexOffset);
+
+    for (juce::uint32 i = 0; i < header.numEntries; ++i)
+    {
+        const auto& entry = entries[i];
+        const auto format = (SampleFormat) entry.format;
+        const bool compressed = format == SampleFormat::Compressed;
+
+        bool valid = entry.numChannels >= 1 && entry.numChannels <= 2
+                  && (format == SampleFormat::Float32 || format == SampleFormat::Int16 || format == SampleFormat::Int24 || compressed)
+                  && juce::isPositiveAndBelow ((int) entry.midiNote, 128)
+                  && entry.numFrames > 0 && entry.numFrames < (juce::uint32) std::numeric_limits<int>::max()
+                  && entry.dataOffset % dataAlignment == 0
+                  && entry.dataOffset <= size
+                  && entry.sampleRate > 0.0
+                  && (juce::uint64) entry.nameOffset + entry.nameLength <= size;
+
+        // Komprimovaný vzorek: hlavička a tabulka bloků kodeku musí sedět na položku
+        if (valid && compressed)
+            valid = entry.channelStride <= size - entry.dataOffset
+                 && SampleCodec::isValid (base + entry.dataOffset, (size_t) entry.channelStride, (int) entry.numFrames, entry.numChannels);
+        else if (valid)
+            valid = entry.channelStride >= (juce::uint64) (entry.numFrames + 1) * getBytesPerSample (format)
+                 && entry.dataOffset + entry.channelStride * entry.numChannels <= size;
+
+        if (! valid)
+        {
+            ITHACA_LOG_WARN ("SampleCache/open", 
+                "Poskozena polozka cache #" + juce::String ((int) i) + ": " + file.getFileName());
+            return false;
+        }
+    }
+
+    mappedFile = std::move (mapping);
+    mappedBase = base;
+    index = entries;
+    numEntries = header.numEntries;
+    return true;
+}
+
+std::vector<std::unique_ptr<SampleData>> SampleCache::createSamples (const juce::File& sampleDirectory) const
+{
+    std::vector<std::unique_ptr<SampleData>> result;
+    if (mappedFile == nullptr)
+        return result;
+
+    result.reserve (numEntries);
+
+    for (juce::uint32 i = 0; i < numEntries; ++i)
+    {
+        const auto& entry = index[i];
+
+        auto sample = std::make_unique<SampleData>();
+        sample->file = sampleDirectory.getChildFile (juce::String::fromUTF8 (mappedBase + entry.nameOffset, (int) entry.nameLength));
+        sample->midiNote = entry.midiNote;
+        sample->dbLevel = entry.dbLevel;
+        sample->variant = entry.variant;
+        sample->sampleRate = entry.sampleRate;
+        sample->numFrames = (int) entry.numFrames;
+        sample->residentFrames = (int) entry.numFrames;
+        sample->numChannels = entry.numChannels;
+        sample->format = (SampleFormat) entry.format;
+        sample->scale = entry.scale;
+
+        const auto channelStride = sample->format == SampleFormat::Compressed ? 0 : entry.channelStride;
+        for (int channel = 0; channel < entry.numChannels; ++channel)
+            sample->channelData[channel] = mappedBase + entry.dataOffset + channelStride * (juce::uint64) channel;
+
+        result.push_back (std::move (sample));
+    }
+
+    return result;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <memory>
+#include <vector>
+#include "SampleLibrary.h"
+
+/**
+ * Třída SampleCache - zabalený cache kontejner předdekódovaných vzorků.
+ *
+ * Jeden soubor místo stovek WAV v samples_tmp (DESIGN7.md, "Správa cache"):
+ *
+ *   [Header][IndexEntry x numEntries][názvy souborů UTF-8][PCM data ...]
+ *
+ * PCM je planární (kanál za kanálem), každý kanál má numFrames + 1 framů
+ * (nulový guard) a začíná na offsetu zarovnaném na dataAlignment bajtů.
+ * Formát je float32, int16 nebo packed int24 (3 bajty) se scale faktorem
+ * na vzorek - celočíselné vzorky (SampleStorage::Native) se ukládají
+ * v bitové hloubce zdrojového WAV, float vzorky volitelně jako int16.
+ * Komprimovaný vzorek (SampleFormat::Compressed) je jeden blok SampleCodec
+ * pro všechny kanály; channelStride je pak zarovnaná velikost bloku.
+ *
+ * Při startu se soubor namapuje (juce::MemoryMappedFile) a přečte se pouze
+ * index; sampler pak čte framy přímo z namapovaných stránek. Start je tedy
+ * O(velikost indexu), ne O(objem audia). Hodnoty jsou v nativním
+ * little-endian pořadí; cizí soubor neprojde kontrolou hlavičky a přestaví se.
+ */
+class SampleCache
+{
+public:
+    static constexpr juce::uint32 formatVersion = 3;
+    static constexpr juce::uint32 dataAlignment = 64;
+
+    SampleCache() = default;
+
+    /**
+     * Zápis kontejneru z načtených (plně rezidentních) vzorků. Celočíselné
+     * vzorky se zapíší ve svém formátu, float vzorky ve floatFormat (Float32,
+     * nebo Int16 se scale podle špičky). Zapisuje se do dočasného souboru,
+     * který se na konci přejmenuje.
+     */
+    static bool write (const juce::File& file, const std::vector<const SampleData*>& samples,
+                       juce::uint64 fingerprint, SampleFormat floatFormat);
+
+    /**
+     * Namapování a validace kontejneru. Vrací false, pokud soubor chybí,
+     * je poškozený, nebo neodpovídá fingerprint zdrojového adresáře.
+     */
+    bool open (const juce::File& file, juce::uint64 expectedFingerprint);
+
+    /**
+     * Vytvoření SampleData ukazujících do namapované paměti (bez kopírování PCM).
+     * Cache musí zůstat naživu, dokud se vzorky používají (SampleData::storage).
+     * SampleData::file se skládá z sampleDirectory a uloženého názvu souboru.
+     */
+    std::vector<std::unique_ptr<SampleData>> createSamples (const juce::File& sampleDirectory) const;
+
+    size_t getMappedSize() const noexcept;
+
+    // Cesta k cache souboru pro daný adresář vzorků
+    static juce::File getCacheFileFor (const juce::File& sampleDirectory);
+
+private:
+    struct Header
+    {
+        char magic[8];
+        juce::uint32 version;
+        juce::uint32 numEntries;
+        juce::uint32 dataAlignment;
+        juce::uint32 reserved;
+        juce::uint64 fingerprint;
+        juce::uint64 indexOffset;
+        juce::uint64 dataOffset;
+    };
+
+    struct IndexEntry
+    {
+        juce::int16 midiNote;
+        juce::int16 dbLevel;
+        juce::int16 variant;
+        juce::uint8 numChannels;
+        juce::uint8 format;         // SampleFormat
+        juce::uint32 numFrames;
+        float scale;                // Int16 / Int24: float = int * scale
+        double sampleRate;
+        juce::uint64 dataOffset;    // Offset prvního kanálu od začátku souboru
+        juce::uint64 channelStride; // Vzdálenost kanálů v bajtech (Compressed: velikost dat)
+        juce::uint32 nameOffset;    // Název zdrojového WAV (UTF-8, bez nuly)
+        juce::uint32 nameLength;
+    };
+
+    static_assert (sizeof (Header) == 48, "Neocekavana velikost SampleCache::Header");
+    static_assert (sizeof (IndexEntry) == 48, "Neocekavana velikost SampleCache::IndexEntry");
+
+    static juce::uint64 alignOffset (juce::uint64 offset) noexcept;
+
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    const IndexEntry* index = nullptr;
+    const char* mappedBase = nullptr;
+    juce::uint32 numEntries = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (SampleCache)
+};
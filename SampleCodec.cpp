@@ -0,0 +1,561 @@
+#include "SampleCodec.h"
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace SampleCodec
+{
+namespace
+{
+    const char codecMagic[4] = { 'I', 'T', 'H', 'Z' };
+    constexpr juce::uint8 codecVersion = 2;
+    constexpr int maxOrder = 3;
+    constexpr int maxRiceParameter = 30;
+
+    struct Header
+    {
+        char magic[4];
+        juce::uint8 version;
+        juce::uint8 numChannels;
+        juce::uint8 bitsPerSample;
+        juce::uint8 reserved;
+        juce::uint32 numFrames;
+        juce::uint32 blockFrames;
+        juce::uint32 numBlocks;
+        juce::uint32 totalBytes;
+    };
+
+    static_assert (sizeof (Header) == 24, "Neocekavana velikost SampleCodec::Header");
+
+    Header readHeader (const void* data) noexcept
+    {
+        Header header;
+        std::memcpy (&header, data, sizeof (header));
+        return header;
+    }
+
+    juce::uint32 readOffset (const void* data, int block) noexcept
+    {
+        juce::uint32 offset;
+        std::memcpy (&offset, static_cast<const char*> (data) + sizeof (Header) + sizeof (juce::uint32) * (size_t) block, sizeof (offset));
+        return offset;
+    }
+
+    size_t getHeaderBytes (int numBlocks) noexcept
+    {
+        return sizeof (Header) + sizeof (juce::uint32) * (size_t) (numBlocks + 1);
+    }
+
+    int countLeadingZeros (juce::uint64 value) noexcept
+    {
+        const auto high = (juce::uint32) (value >> 32);
+        return high != 0 ? 31 - juce::findHighestSetBit (high) : 63 - juce::findHighestSetBit ((juce::uint32) value);
+    }
+
+    juce::uint32 toZigzag (int value) noexcept    { return ((juce::uint32) value << 1) ^ (juce::uint32) (value >> 31); }
+    int fromZigzag (juce::uint32 value) noexcept  { return (int) (value >> 1) ^ -(int) (value & 1); }
+
+    // Pevný prediktor řádu order (0-3) pro vzorek i >= order
+    juce::int64 predict (const int* x, int i, int order) noexcept
+    {
+        switch (order)
+        {
+            case 1:  return x[i - 1];
+            case 2:  return 2 * (juce::int64) x[i - 1] - x[i - 2];
+            case 3:  return 3 * ((juce::int64) x[i - 1] - x[i - 2]) + x[i - 3];
+            default: return 0;
+        }
+    }
+
+    //==============================================================================
+    struct BitWriter
+    {
+        std::vector<juce::uint8> bytes;
+        juce::uint64 accumulator = 0;
+        int numBits = 0;
+
+        // n <= 32
+        void write (juce::uint32 value, int n)
+        {
+            if (n == 0)
+                return;
+
+            accumulator = (accumulator << n) | ((juce::uint64) value & (((juce::uint64) 1 << n) - 1));
+            numBits += n;
+
+            while (numBits >= 8)
+            {
+                numBits -= 8;
+                bytes.push_back ((juce::uint8) (accumulator >> numBits));
+            }
+        }
+
+        // quotient nul a ukončovací jednička
+        void writeUnary (juce::uint32 quotient)
+        {
+            for (; quotient >= 32; quotient -= 32)
+                write (0, 32);
+
+            write (1, (int) quotient + 1);
+        }
+
+        void alignToByte()
+        {
+            if (numBits > 0)
+                write (0, 8 - numBits);
+        }
+    };
+
+    /**
+     * Čtení bitového proudu bloku. Za koncem dat čte nuly a bitsLeft jde
+     * do záporu - volající to po dekódování kontroluje.
+     */
+    struct BitReader
+    {
+        const juce::uint8* next;
+        const juce::uint8* end;
+        juce::uint64 cache = 0;
+        int numBits = 0;
+        juce::int64 bitsLeft;
+
+        BitReader (const juce::uint8* start, const juce::uint8* stop) noexcept
+            : next (start), end (stop), bitsLeft ((juce::int64) (stop - start) * 8)
+        {
+        }
+
+        // Pokračování v rozpracovaném proudu (stav uložený mezi oddíly)
+        BitReader (const juce::uint8* start, const juce::uint8* stop, juce::uint64 bitCache, int cachedBits, juce::int64 remaining) noexcept
+            : next (start), end (stop), cache (bitCache), numBits (cachedBits), bitsLeft (remaining)
+        {
+        }
+
+        void refill() noexcept
+        {
+            while (numBits <= 56)
+            {
+                const juce::uint64 byte = next < end ? *next++ : 0;
+                cache |= byte << (56 - numBits);
+                numBits += 8;
+            }
+        }
+
+        // n <= 32
+        juce::uint32 read (int n) noexcept
+        {
+            if (n == 0)
+                return 0;
+
+            refill();
+            const auto value = (juce::uint32) (cache >> (64 - n));
+            cache <<= n;
+            numBits -= n;
+            bitsLeft -= n;
+            return value;
+        }
+
+        juce::uint32 readUnary() noexcept
+        {
+            juce::uint32 quotient = 0;
+
+            for (;;)
+            {
+                refill();
+
+                if (cache != 0)
+                {
+                    const int zeros = countLeadingZeros (cache);
+                    cache <<= zeros + 1;
+                    numBits -= zeros + 1;
+                    bitsLeft -= zeros + 1;
+                    return quotient + (juce::uint32) zeros;
+                }
+
+                // Samé nuly - poškozená data, za koncem se smyčka ukončí
+                quotient += (juce::uint32) numBits;
+                bitsLeft -= numBits;
+                numBits = 0;
+
+                if (bitsLeft < 0)
+                    return quotient;
+            }
+        }
+    };
+
+    //==============================================================================
+    int chooseOrder (const int* x, int numFrames, juce::uint64& bestCost)
+    {
+        int bestOrder = 0;
+        bestCost = std::numeric_limits<juce::uint64>::max();
+
+        for (int order = 0; order <= juce::jmin (maxOrder, numFrames); ++order)
+        {
+            juce::uint64 cost = 0;
+            for (int i = order; i < numFrames; ++i)
+                cost += (juce::uint64) std::abs (x[i] - predict (x, i, order));
+
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestOrder = order;
+            }
+        }
+
+        return bestOrder;
+    }
+
+    // k s nejkratším zápisem oddílu: count * (k + 1) + součet (u >> k)
+    int chooseRiceParameter (const juce::uint32* values, int count)
+    {
+        int bestParameter = 0;
+        juce::uint64 bestBits = std::numeric_limits<juce::uint64>::max();
+
+        for (int k = 0; k <= maxRiceParameter; ++k)
+        {
+            juce::uint64 bits = (juce::uint64) count * (juce::uint64) (k + 1);
+            for (int i = 0; i < count; ++i)
+                bits += values[i] >> k;
+
+            if (bits < bestBits)
+            {
+                bestBits = bits;
+                bestParameter = k;
+            }
+        }
+
+        return bestParameter;
+    }
+
+    void encodeChannel (BitWriter& writer, const int* x, int numFrames, std::vector<juce::uint32>& residuals)
+    {
+        juce::uint64 cost;
+        const int order = chooseOrder (x, numFrames, cost);
+        writer.write ((juce::uint32) order, 2);
+
+        for (int i = 0; i < order; ++i)
+            writer.write ((juce::uint32) x[i], 32);
+
+        residuals.resize ((size_t) numFrames);
+        for (int i = order; i < numFrames; ++i)
+            residuals[(size_t) i] = toZigzag ((int) (x[i] - predict (x, i, order)));
+
+        for (int start = order; start < numFrames; start += partitionFrames)
+        {
+            const int count = juce::jmin (partitionFrames, numFrames - start);
+            const int k = chooseRiceParameter (residuals.data() + start, count);
+            writer.write ((juce::uint32) k, 5);
+
+            for (int i = start; i < start + count; ++i)
+            {
+                const auto value = residuals[(size_t) i];
+                writer.writeUnary (value >> k);
+                writer.write (value, k);
+            }
+        }
+    }
+
+    /**
+     * Dekódování oddílu reziduí - smyčka zvlášť pro každý řád, aby predikce
+     * neměla ve smyčce větvení. Historie prediktoru se drží v registrech
+     * a mezi oddíly v history, takže x může volající po oddílech přepisovat
+     * (převod side na pravý kanál).
+     */
+    template <int Order>
+    void decodeResiduals (BitReader& reader, int* x, int start, int count, int k, int* history) noexcept
+    {
+        juce::int64 h1 = history[0], h2 = history[1], h3 = history[2];
+
+        for (int i = start; i < start + count; ++i)
+        {
+            const auto quotient = reader.readUnary();
+            const int residual = fromZigzag ((quotient << k) | reader.read (k));
+            const juce::int64 prediction = Order == 0 ? 0
+                                         : Order == 1 ? h1
+                                         : Order == 2 ? 2 * h1 - h2
+                                                      : 3 * (h1 - h2) + h3;
+
+            const int value = (int) (residual + prediction);
+            x[i] = value;
+            h3 = h2;
+            h2 = h1;
+            h1 = value;
+        }
+
+        history[0] = (int) h1;
+        history[1] = (int) h2;
+        history[2] = (int) h3;
+    }
+}
+
+//==============================================================================
+juce::MemoryBlock encode (const int* const* channels, int numChannels, int numFrames, int bitsPerSample)
+{
+    if (numChannels < 1 || numChannels > 2 || numFrames <= 0 || (bitsPerSample != 16 && bitsPerSample != 24))
+        return {};
+
+    const int numBlocks = (numFrames + blockFrames - 1) / blockFrames;
+    const auto headerBytes = getHeaderBytes (numBlocks);
+
+    BitWriter writer;
+    std::vector<juce::uint32> offsets;
+    std::vector<juce::uint32> residuals;
+    std::vector<int> side ((size_t) blockFrames);
+    offsets.reserve ((size_t) numBlocks + 1);
+
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        offsets.push_back ((juce::uint32) (headerBytes + writer.bytes.size()));
+
+        const int start = block * blockFrames;
+        const int count = juce::jmin (blockFrames, numFrames - start);
+        const auto blockStart = writer.bytes.size();
+        const int* left = channels[0] + start;
+
+        // Místo pro offset druhého kanálu (doplní se po zápisu levého)
+        if (numChannels > 1)
+            writer.write (0, 32);
+
+        encodeChannel (writer, left, count, residuals);
+        writer.alignToByte();
+
+        if (numChannels > 1)
+        {
+            const auto secondChannelOffset = (juce::uint32) (writer.bytes.size() - blockStart);
+            std::memcpy (writer.bytes.data() + blockStart, &secondChannelOffset, sizeof (secondChannelOffset));
+
+            // Side (L - R) místo pravého kanálu, pokud se predikuje levněji
+            const int* right = channels[1] + start;
+            for (int i = 0; i < count; ++i)
+                side[(size_t) i] = left[i] - right[i];
+
+            juce::uint64 rightCost, sideCost;
+            chooseOrder (right, count, rightCost);
+            chooseOrder (side.data(), count, sideCost);
+
+            const bool useSide = sideCost < rightCost;
+            writer.write (useSide ? 1 : 0, 1);
+            encodeChannel (writer, useSide ? side.data() : right, count, residuals);
+        }
+
+        writer.alignToByte();
+    }
+
+    const auto totalBytes = headerBytes + writer.bytes.size();
+    if (totalBytes > std::numeric_limits<juce::uint32>::max())
+        return {};
+
+    offsets.push_back ((juce::uint32) totalBytes);
+
+    Header header {};
+    std::memcpy (header.magic, codecMagic, sizeof (header.magic));
+    header.version = codecVersion;
+    header.numChannels = (juce::uint8) numChannels;
+    header.bitsPerSample = (juce::uint8) bitsPerSample;
+    header.numFrames = (juce::uint32) numFrames;
+    header.blockFrames = (juce::uint32) blockFrames;
+    header.numBlocks = (juce::uint32) numBlocks;
+    header.totalBytes = (juce::uint32) totalBytes;
+
+    juce::MemoryBlock result (totalBytes);
+    auto* out = static_cast<char*> (result.getData());
+    std::memcpy (out, &header, sizeof (header));
+    std::memcpy (out + sizeof (header), offsets.data(), sizeof (juce::uint32) * offsets.size());
+    std::memcpy (out + headerBytes, writer.bytes.data(), writer.bytes.size());
+    return result;
+}
+
+bool isValid (const void* data, size_t size, int numFrames, int numChannels) noexcept
+{
+    if (data == nullptr || size < sizeof (Header))
+        return false;
+
+    const auto header = readHeader (data);
+    const auto numBlocks = (juce::uint64) header.numBlocks;
+
+    if (std::memcmp (header.magic, codecMagic, sizeof (header.magic)) != 0
+        || header.version != codecVersion
+        || (int) header.numChannels != numChannels
+        || (header.bitsPerSample != 16 && header.bitsPerSample != 24)
+        || header.numFrames != (juce::uint32) numFrames
+        || header.blockFrames != (juce::uint32) blockFrames
+        || numBlocks != ((juce::uint64) numFrames + blockFrames - 1) / blockFrames
+        || getHeaderBytes ((int) numBlocks) > size
+        || header.totalBytes > size)
+        return false;
+
+    // Offsety vzestupně od konce tabulky po totalBytes
+    juce::uint32 previous = (juce::uint32) getHeaderBytes ((int) numBlocks);
+    for (int block = 0; block <= (int) numBlocks; ++block)
+    {
+        const auto offset = readOffset (data, block);
+        if (offset < previous || (block == 0 && offset != previous))
+            return false;
+
+        previous = offset;
+    }
+
+    return previous == header.totalBytes;
+}
+
+size_t getEncodedSize (const void* data) noexcept
+{
+    return readHeader (data).totalBytes;
+}
+
+int getBitsPerSample (const void* data) noexcept
+{
+    return readHeader (data).bitsPerSample;
+}
+
+//==============================================================================
+bool Decoder::start (const void* data, int newBlock, int* const* dest) noexcept
+{
+    block = -1;
+    failed = false;
+    numDecoded = 0;
+    useSide = false;
+
+    const auto header = readHeader (data);
+    if (! juce::isPositiveAndBelow (newBlock, (int) header.numBlocks))
+        return false;
+
+    numFrames = juce::jmin (blockFrames, (int) header.numFrames - newBlock * blockFrames);
+    numChannels = header.numChannels;
+
+    const auto* base = static_cast<const juce::uint8*> (data);
+    const auto* blockBegin = base + readOffset (data, newBlock);
+    const auto* blockEnd = base + readOffset (data, newBlock + 1);
+
+    if (numChannels > 1)
+    {
+        juce::uint32 secondChannelOffset = 0;
+        if (blockEnd - blockBegin < (std::ptrdiff_t) sizeof (secondChannelOffset))
+            return false;
+
+        std::memcpy (&secondChannelOffset, blockBegin, sizeof (secondChannelOffset));
+        if (secondChannelOffset < sizeof (secondChannelOffset) || secondChannelOffset > (juce::uint32) (blockEnd - blockBegin))
+            return false;
+
+        if (! startChannel (channels[0], blockBegin + sizeof (secondChannelOffset), blockBegin + secondChannelOffset, dest[0], nullptr)
+            || ! startChannel (channels[1], blockBegin + secondChannelOffset, blockEnd, dest[1], &useSide))
+            return false;
+    }
+    else if (! startChannel (channels[0], blockBegin, blockEnd, dest[0], nullptr))
+    {
+        return false;
+    }
+
+    block = newBlock;
+    return true;
+}
+
+// Hlavička kanálu: bit režimu (jen druhý kanál sterea, side != nullptr), řád a warm-up vzorky
+bool Decoder::startChannel (ChannelState& channel, const juce::uint8* begin, const juce::uint8* stop, int* dest, bool* side) noexcept
+{
+    BitReader reader (begin, stop);
+
+    if (side != nullptr)
+        *side = reader.read (1) != 0;
+
+    channel.order = (int) reader.read (2);
+    if (channel.order > numFrames)
+        return false;
+
+    for (int i = 0; i < channel.order; ++i)
+        dest[i] = (int) reader.read (32);
+
+    for (int i = 0; i < 3; ++i)
+        channel.history[i] = i < channel.order ? dest[channel.order - 1 - i] : 0;
+
+    channel.next = reader.next;
+    channel.end = reader.end;
+    channel.cache = reader.cache;
+    channel.numBits = reader.numBits;
+    channel.bitsLeft = reader.bitsLeft;
+    channel.position = channel.order;
+    channel.dest = dest;
+    return reader.bitsLeft >= 0;
+}
+
+bool Decoder::decodePartition (ChannelState& channel) noexcept
+{
+    BitReader reader (channel.next, channel.end, channel.cache, channel.numBits, channel.bitsLeft);
+
+    const int count = juce::jmin (partitionFrames, numFrames - channel.position);
+    const int k = (int) reader.read (5);
+
+    if (k > maxRiceParameter)
+        return false;
+
+    switch (channel.order)
+    {
+        case 0:  decodeResiduals<0> (reader, channel.dest, channel.position, count, k, channel.history); break;
+        case 1:  decodeResiduals<1> (reader, channel.dest, channel.position, count, k, channel.history); break;
+        case 2:  decodeResiduals<2> (reader, channel.dest, channel.position, count, k, channel.history); break;
+        default: decodeResiduals<3> (reader, channel.dest, channel.position, count, k, channel.history); break;
+    }
+
+    channel.next = reader.next;
+    channel.cache = reader.cache;
+    channel.numBits = reader.numBits;
+    channel.bitsLeft = reader.bitsLeft;
+    channel.position += count;
+    return reader.bitsLeft >= 0;
+}
+
+bool Decoder::decodeUntil (int endFrame) noexcept
+{
+    if (block < 0 || failed)
+        return false;
+
+    endFrame = juce::jmin (endFrame, numFrames);
+
+    while (numDecoded < endFrame)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            if (channels[channel].position < endFrame && ! decodePartition (channels[channel]))
+            {
+                failed = true;
+                return false;
+            }
+        }
+
+        // Kanály mohou mít různý řád (a tedy hranice oddílů) - hotové je minimum
+        const int decoded = numChannels > 1 ? juce::jmin (channels[0].position, channels[1].position) : channels[0].position;
+
+        if (useSide)
+            for (int i = numDecoded; i < decoded; ++i)
+                channels[1].dest[i] = (int) ((juce::uint32) channels[0].dest[i] - (juce::uint32) channels[1].dest[i]);
+
+        numDecoded = decoded;
+    }
+
+    return true;
+}
+
+int decodeBlock (const void* data, int block, int* const* dest) noexcept
+{
+    Decoder decoder;
+    return decoder.start (data, block, dest) && decoder.decodeUntil (blockFrames) ? decoder.getNumFrames() : 0;
+}
+
+bool decode (const void* data, float* const* dest, float scale)
+{
+    const auto header = readHeader (data);
+    std::vector<int> decoded ((size_t) blockFrames * 2);
+    int* const blockChannels[2] = { decoded.data(), decoded.data() + blockFrames };
+
+    for (int block = 0; block < (int) header.numBlocks; ++block)
+    {
+        const int numFrames = decodeBlock (data, block, blockChannels);
+        if (numFrames == 0)
+            return false;
+
+        for (int channel = 0; channel < header.numChannels; ++channel)
+            for (int i = 0; i < numFrames; ++i)
+                dest[channel][block * blockFrames + i] = (float) blockChannels[channel][i] * scale;
+    }
+
+    return true;
+}
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+/**
+ * SampleCodec - bezeztrátová komprese rezidentních vzorků po blocích (podobně jako FLAC).
+ *
+ * Vzorek se dělí na bloky po blockFrames framech; každý blok jde dekódovat
+ * samostatně, takže note-on i skok na pozici (smyčka) dekóduje jen začátek
+ * jednoho bloku (Decoder):
+ *
+ *   [Header][offset bloku x (numBlocks + 1)][blok 0][blok 1] ...
+ *
+ * Kanál bloku je samostatný bitový proud (MSB first) začínající na celém
+ * bajtu. U sterea začíná blok offsetem druhého kanálu (uint32 od začátku
+ * bloku), následuje levý kanál a druhý kanál uvozený 1 bitem režimu
+ * (0 = pravý kanál, 1 = side = L - R) - oba kanály tak jde dekódovat
+ * souběžně po oddílech. Kanál: 2 bity řád pevného prediktoru (0-3), warm-up
+ * vzorky po 32 bitech, rezidua po oddílech partitionFrames - 5 bitů Rice
+ * parametr k, pak kódy (zigzag, unární podíl, k bitů zbytku).
+ *
+ * Řád prediktoru a režim kanálů volí enkodér podle součtu |rezidua| bloku,
+ * k podle přesné délky oddílu. Dekodér je bez alokací a kontroluje meze -
+ * poškozený blok vrátí 0 framů, nikdy nečte mimo data. Vstupem jsou celá
+ * čísla s 16 nebo 24 platnými bity (float = hodnota * SampleData::scale).
+ */
+namespace SampleCodec
+{
+    constexpr int blockFrames = 4096;
+    constexpr int partitionFrames = 256;
+
+    /**
+     * Komprese celého vzorku (mimo audio vlákno). channels jsou int32
+     * zarovnané doprava (rozsah bitsPerSample bitů); vrací prázdný blok,
+     * pokud vstup nelze zakódovat.
+     */
+    juce::MemoryBlock encode (const int* const* channels, int numChannels, int numFrames, int bitsPerSample);
+
+    // Kontrola hlavičky a tabulky bloků (např. dat z namapované cache)
+    bool isValid (const void* data, size_t size, int numFrames, int numChannels) noexcept;
+
+    size_t getEncodedSize (const void* data) noexcept;
+    int getBitsPerSample (const void* data) noexcept;
+
+    /**
+     * Postupné dekódování jednoho bloku po oddílech do int32 polí volajícího.
+     * Audio vlákno tak dekóduje jen framy, které právě přehrává - cena na
+     * callback odpovídá přehraným framům (plus nejvýš oddíl), ne celému bloku.
+     * Bez alokací, real-time safe.
+     */
+    class Decoder
+    {
+    public:
+        Decoder() = default;
+
+        /**
+         * Začátek bloku: načte řády prediktorů a warm-up vzorky. dest[kanál]
+         * musí mít blockFrames prvků a platit po celou dobu dekódování bloku.
+         * Vrací false pro neplatný index nebo poškozený začátek bloku.
+         */
+        bool start (const void* data, int block, int* const* dest) noexcept;
+
+        /**
+         * Dekódování dalších oddílů, dokud nejsou platné framy [0, endFrame)
+         * obou kanálů (endFrame se omezí délkou bloku). false = poškozený blok.
+         */
+        bool decodeUntil (int endFrame) noexcept;
+
+        void reset() noexcept { block = -1; }
+
+        int getBlock() const noexcept       { return block; }       // -1 = žádný blok
+        int getNumFrames() const noexcept   { return numFrames; }
+        int getNumDecoded() const noexcept  { return numDecoded; }
+        bool hasFailed() const noexcept     { return failed; }
+
+    private:
+        struct ChannelState
+        {
+            const juce::uint8* next = nullptr;      // Stav čtení bitového proudu kanálu
+            const juce::uint8* end = nullptr;
+            juce::uint64 cache = 0;
+            int numBits = 0;
+            juce::int64 bitsLeft = 0;
+            int order = 0;
+            int position = 0;                       // Další dekódovaný frame
+            int history[3] = {};                    // x[i - 1], x[i - 2], x[i - 3] pro prediktor
+            int* dest = nullptr;
+        };
+
+        bool startChannel (ChannelState& channel, const juce::uint8* begin, const juce::uint8* stop, int* dest, bool* side) noexcept;
+        bool decodePartition (ChannelState& channel) noexcept;
+
+        ChannelState channels[2];
+        int block = -1;
+        int numFrames = 0;
+        int numChannels = 0;
+        int numDecoded = 0;         // Framy hotové v obou kanálech (včetně převodu side)
+        bool useSide = false;
+        bool failed = false;
+    };
+
+    /**
+     * Dekódování celého bloku do int32 (dest[kanál][0 .. blockFrames)). Real-time safe.
+     * Vrací počet framů bloku, 0 pro neplatný index nebo poškozený blok.
+     */
+    int decodeBlock (const void* data, int block, int* const* dest) noexcept;
+
+    // Dekódování celého vzorku do float (dest[kanál][0 .. numFrames)); mimo audio vlákno
+    bool decode (const void* data, float* const* dest, float scale);
+}
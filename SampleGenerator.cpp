@@ -0,0 +1,476 @@
+#include "SampleGenerator.h"
+#include "Logger.h"
+#include "MixKernels.h"
+#include "SampleCodec.h"
+#include <functional>
+#include <map>
+#include <set>
+
+namespace
+{
+    // Verze algoritmu - zvýšit při změně výpočtu, aby se cache přestavěla
+    constexpr juce::uint64 generatorVersion = 2;     // 2: klíč z obsahu zdroje
+
+    // Body tabulky jádra na jeden vstupní vzorek (lineární interpolace mezi nimi)
+    constexpr double kernelResolution = 256.0;
+
+    double besselI0 (double x) noexcept
+    {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 50; ++k)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+            if (term < sum * 1.0e-12)
+                break;
+        }
+
+        return sum;
+    }
+
+    juce::uint64 mixHash (juce::uint64 hash, juce::uint64 value) noexcept
+    {
+        // FNV-1a po bajtech hodnoty
+        for (int i = 0; i < 8; ++i)
+        {
+            hash ^= (value >> (i * 8)) & 0xff;
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+
+    // Spuštění job(0 .. count-1) - s poolem paralelně, jinak postupně; vrací po dokončení všech
+    void runJobs (size_t count, juce::ThreadPool* pool, const std::function<void (size_t)>& job)
+    {
+        if (pool == nullptr || count < 2)
+        {
+            for (size_t i = 0; i < count; ++i)
+                job (i);
+
+            return;
+        }
+
+        std::atomic<size_t> remaining { count };
+        juce::WaitableEvent allDone;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            pool->addJob ([&, i]
+            {
+                job (i);
+
+                if (--remaining == 0)
+                    allDone.signal();
+            });
+        }
+
+        allDone.wait();
+    }
+}
+
+//==============================================================================
+std::vector<SampleGenerator::Task> SampleGenerator::planMissingNotes (const std::vector<std::shared_ptr<const SampleData>>& recorded)
+{
+    std::array<bool, 128> hasNote {};
+    for (const auto& sample : recorded)
+        if (! sample->generated)
+            hasNote[(size_t) sample->midiNote] = true;
+
+    std::vector<Task> tasks;
+
+    for (int note = IthacaConfig::MIDI_NOTE_MIN; note <= IthacaConfig::MIDI_NOTE_MAX; ++note)
+    {
+        if (hasNote[(size_t) note])
+            continue;
+
+        // Nejbližší nahraná nota - stejné pořadí hledání jako SampleLibrary::buildNoteMap
+        int sourceNote = -1;
+        for (int distance = 1; distance <= IthacaConfig::MAX_PITCH_SHIFT && sourceNote < 0; ++distance)
+            for (int candidate : { note - distance, note + distance })
+                if (sourceNote < 0 && juce::isPositiveAndBelow (candidate, 128) && hasNote[(size_t) candidate])
+                    sourceNote = candidate;
+
+        if (sourceNote < 0)
+            continue;
+
+        for (const auto& sample : recorded)
+            if (! sample->generated && sample->midiNote == sourceNote)
+                tasks.push_back ({ sample, note });
+    }
+
+    return tasks;
+}
+
+juce::File SampleGenerator::getCacheFileFor (const SampleData& source, juce::uint64 contentHash, int targetNote)
+{
+    // FNV-1a přes obsah a název zdroje (stejný obsah dvou souborů nesdílí výsledek), posun a parametry resampleru
+    juce::uint64 hash = 14695981039346656037ull;
+    auto mix = [&hash] (juce::uint64 value)
+    {
+        hash = mixHash (hash, value);
+    };
+
+    auto mixDouble = [&mix] (double value)
+    {
+        juce::uint64 bits;
+        std::memcpy (&bits, &value, sizeof (bits));
+        mix (bits);
+    };
+
+    mix (generatorVersion);
+    mix (contentHash);
+    mix ((juce::uint64) source.file.getFileName().hashCode64());
+    mix ((juce::uint64) (juce::int64) (targetNote - source.midiNote));
+    mixDouble (source.sampleRate);
+    mix ((juce::uint64) sincZeroCrossings);
+    mixDouble (kaiserBeta);
+    mixDouble (cutoff);
+
+    return IthacaConfig::getCacheDirectory()
+               .getChildFile ("generated")
+               .getChildFile (getDirectoryPrefix (source.file.getParentDirectory()) + juce::String (targetNote).paddedLeft ('0', 3)
+                              + "_" + juce::String::toHexString ((juce::int64) hash).paddedLeft ('0', 16) + ".wav");
+}
+
+// "g<hash adresáře vzorků>_" - výsledky jednoho nástroje ve společném adresáři cache
+juce::String SampleGenerator::getDirectoryPrefix (const juce::File& sampleDirectory)
+{
+    const auto hash = mixHash (14695981039346656037ull, (juce::uint64) sampleDirectory.getFullPathName().hashCode64());
+    return "g" + juce::String::toHexString ((juce::int64) hash).paddedLeft ('0', 16) + "_";
+}
+
+/**
+ * Hash celého souboru po 64bitových slovech (násobení a rotace - rychlejší
+ * než čtení z disku), zbytek po bajtech. Mění se s jakoukoli změnou dat
+ * bez ohledu na název, velikost a čas změny.
+ */
+juce::uint64 SampleGenerator::hashFileContent (const juce::File& file)
+{
+    juce::FileInputStream in (file);
+    if (! in.openedOk())
+        return 0;
+
+    juce::uint64 hash = mixHash (14695981039346656037ull, (juce::uint64) in.getTotalLength());
+    std::vector<char> buffer ((size_t) 1 << 16);
+
+    for (int numRead; (numRead = in.read (buffer.data(), (int) buffer.size())) > 0;)
+    {
+        int i = 0;
+        for (; i + 8 <= numRead; i += 8)
+        {
+            juce::uint64 word;
+            std::memcpy (&word, buffer.data() + i, sizeof (word));
+
+            hash ^= word * 0x9e3779b97f4a7c15ull;
+            hash = ((hash << 29) | (hash >> 35)) * 0xbf58476d1ce4e5b9ull;
+        }
+
+        for (; i < numRead; ++i)
+            hash = (hash ^ (juce::uint8) buffer[(size_t) i]) * 1099511628211ull;
+    }
+
+    return hash != 0 ? hash : 1;
+}
+
+//==============================================================================
+/**
+ * Spuštění všech úloh (paralelně přes pool) a sesbírání výsledků v pořadí úloh.
+ */
+std::vector<std::shared_ptr<const SampleData>> SampleGenerator::generate (const std::vector<Task>& tasks, const SamplerSettings& settings,
+                                                                          juce::ThreadPool* pool, SampleLoadProgress* progress)
+{
+    SampleLoadProgress localProgress;
+    if (progress == nullptr)
+        progress = &localProgress;
+
+    progress->filesTotal = (int) tasks.size();
+    progress->bytesTotal = 0;
+
+    std::vector<std::shared_ptr<const SampleData>> results (tasks.size());
+    std::atomic<int> numFailed { 0 };
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    // Klíče cache z obsahu zdrojů - každý zdroj (slouží více cílovým notám) se čte jednou
+    std::map<const SampleData*, size_t> sourceIndices;
+    std::vector<const SampleData*> sources;
+    std::vector<size_t> sourceOfTask (tasks.size());
+
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+        const auto inserted = sourceIndices.emplace (tasks[i].source.get(), sources.size());
+        if (inserted.second)
+            sources.push_back (tasks[i].source.get());
+
+        sourceOfTask[i] = inserted.first->second;
+    }
+
+    std::vector<juce::uint64> contentHashes (sources.size());
+    runJobs (sources.size(), pool, [&] (size_t index)
+    {
+        if (! progress->cancelled.load (std::memory_order_relaxed))
+            contentHashes[index] = hashFileContent (sources[index]->file);
+    });
+
+    std::vector<juce::File> cacheFiles (tasks.size());
+    for (size_t i = 0; i < tasks.size(); ++i)
+        cacheFiles[i] = getCacheFileFor (*tasks[i].source, contentHashes[sourceOfTask[i]], tasks[i].targetNote);
+
+    runJobs (tasks.size(), pool, [&] (size_t index)
+    {
+        if (progress->cancelled.load (std::memory_order_relaxed))
+            return;
+
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        results[index] = runTask (tasks[index], cacheFiles[index], settings, formatManager);
+
+        if (results[index] == nullptr)
+            ++numFailed;
+
+        ++progress->filesDone;
+    });
+
+    if (progress->cancelled.load())
+        return {};
+
+    removeStaleFiles (tasks, cacheFiles);
+
+    std::vector<std::shared_ptr<const SampleData>> generated;
+    for (auto& sample : results)
+        if (sample != nullptr)
+            generated.push_back (std::move (sample));
+
+    ITHACA_LOG_INFO ("SampleGenerator/generate", 
+        "Vygenerovano " + juce::String ((int) generated.size()) + " vzorku chybejicich not ("
+        + juce::String (numFailed.load()) + " chyb) za "
+        + juce::String ((juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0, 2) + " s");
+
+    return generated;
+}
+
+/**
+ * Jedna úloha: výsledek z cache, nebo převzorkování a zápis; pak načtení jako běžný vzorek.
+ */
+std::shared_ptr<const SampleData> SampleGenerator::runTask (const Task& task, const juce::File& cacheFile, const SamplerSettings& settings,
+                                                            juce::AudioFormatManager& formatManager)
+{
+    const auto& source = *task.source;
+
+    SampleFileInfo info;
+    info.file = cacheFile;
+    info.midiNote = task.targetNote;
+    info.dbLevel = source.dbLevel;
+    info.variant = source.variant;
+
+    // Platný výsledek z minulého běhu - žádná práce
+    if (cacheFile.existsAsFile())
+    {
+        if (auto sample = SampleLibrary::loadSample (formatManager, info, settings))
+        {
+            sample->generated = true;
+            return sample;
+        }
+
+        cacheFile.deleteFile();
+    }
+
+    juce::AudioBuffer<float> input;
+    if (! readSource (source, input, formatManager))
+        return nullptr;
+
+    const double ratio = std::pow (2.0, (task.targetNote - source.midiNote) / 12.0);
+    if (! renderToFile (source, input, ratio, cacheFile))
+    {
+        ITHACA_LOG_ERROR ("SampleGenerator/runTask", 
+            "Chyba pri generovani noty " + juce::String (task.targetNote) + " z " + source.file.getFileName());
+        return nullptr;
+    }
+
+    auto sample = SampleLibrary::loadSample (formatManager, info, settings);
+    if (sample != nullptr)
+        sample->generated = true;
+
+    return sample;
+}
+
+/**
+ * Smazání výsledků nástroje (prefix adresáře vzorků), které dokončený běh
+ * nepoužil: klíče změněných zdrojů a parametrů, noty, které už jsou nahrané,
+ * a výsledky smazaných zdrojů. Výsledky jiných nástrojů ve společném adresáři
+ * cache zůstávají; soubory starého pojmenování (bez adresáře, verze 1) se
+ * mažou také - nový klíč je nikdy nepoužije.
+ */
+void SampleGenerator::removeStaleFiles (const std::vector<Task>& tasks, const std::vector<juce::File>& usedFiles)
+{
+    if (tasks.empty())
+        return;
+
+    const auto prefix = getDirectoryPrefix (tasks.front().source->file.getParentDirectory());
+
+    std::set<juce::String> used;
+    for (const auto& file : usedFiles)
+        used.insert (file.getFileName());
+
+    int numRemoved = 0;
+    for (const auto& file : IthacaConfig::getCacheDirectory().getChildFile ("generated").findChildFiles (juce::File::findFiles, false, "g*.wav"))
+    {
+        const auto name = file.getFileName();
+        const bool legacyName = name.indexOfChar ('_') == name.lastIndexOfChar ('_');
+
+        if ((legacyName || name.startsWith (prefix)) && used.count (name) == 0 && file.deleteFile())
+            ++numRemoved;
+    }
+
+    if (numRemoved > 0)
+        ITHACA_LOG_INFO ("SampleGenerator/removeStaleFiles", "Smazano " + juce::String (numRemoved) + " zastaralych vygenerovanych vzorku");
+}
+
+/**
+ * Celý zdrojový vzorek jako float. Rezidentní data se převezmou z paměti (komprimovaná se dekódují),
+ * streamovaný (DFD) vzorek se dekóduje ze souboru.
+ */
+bool SampleGenerator::readSource (const SampleData& source, juce::AudioBuffer<float>& destination,
+                                  juce::AudioFormatManager& formatManager)
+{
+    const int numChannels = source.getNumChannels();
+    destination.setSize (numChannels, source.numFrames);
+
+    if (source.format == SampleFormat::Compressed)
+        return SampleCodec::decode (source.channelData[0], destination.getArrayOfWritePointers(), source.scale);
+
+    if (! source.isStreamed())
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* out = destination.getWritePointer (channel);
+
+            if (source.format == SampleFormat::Int16)
+            {
+                MixKernels::get().int16ToFloat (out, source.getChannel<juce::int16> (channel), source.numFrames, source.scale);
+            }
+            else if (source.format == SampleFormat::Int24)
+            {
+                MixKernels::get().int24ToFloat (out, source.getChannel<juce::uint8> (channel), source.numFrames, source.scale);
+            }
+            else
+            {
+                std::memcpy (out, source.getChannel<float> (channel), sizeof (float) * (size_t) source.numFrames);
+            }
+        }
+
+        return true;
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> reader (formatManager.createReaderFor (source.file));
+    if (reader == nullptr)
+        return false;
+
+    return reader->read (&destination, 0, source.numFrames, 0, true, numChannels > 1);
+}
+
+bool SampleGenerator::renderToFile (const SampleData& source, const juce::AudioBuffer<float>& input,
+                                    double ratio, const juce::File& target)
+{
+    // Jádro pro tento poměr: při posunu nahoru se pásmo zužuje (antialiasing) a jádro prodlužuje
+    const double cut = cutoff * juce::jmin (1.0, 1.0 / ratio);
+    const double halfWidth = sincZeroCrossings / cut;
+    const double windowNorm = besselI0 (kaiserBeta);
+
+    std::vector<float> kernel ((size_t) std::ceil (halfWidth * kernelResolution) + 2);
+    for (size_t j = 0; j < kernel.size(); ++j)
+    {
+        const double t = (double) j / kernelResolution;
+        const double x = t / halfWidth;
+
+        if (x >= 1.0)
+        {
+            kernel[j] = 0.0f;
+            continue;
+        }
+
+        const double arg = juce::MathConstants<double>::pi * cut * t;
+        const double sinc = t == 0.0 ? 1.0 : std::sin (arg) / arg;
+        kernel[j] = (float) (cut * sinc * besselI0 (kaiserBeta * std::sqrt (1.0 - x * x)) / windowNorm);
+    }
+
+    const int numOutput = (int) ((source.numFrames - 1) / ratio) + 1;
+    juce::AudioBuffer<float> output (input.getNumChannels(), numOutput);
+
+    for (int channel = 0; channel < input.getNumChannels(); ++channel)
+        resample (input.getReadPointer (channel), input.getNumSamples(), output.getWritePointer (channel), numOutput,
+                  ratio, kernel, kernelResolution);
+
+    // Zápis přes dočasný soubor, aby přerušený běh nezanechal neúplný výsledek
+    if (! target.getParentDirectory().createDirectory())
+        return false;
+
+    const auto tempFile = target.getSiblingFile (target.getFileName() + ".tmp");
+    tempFile.deleteFile();
+
+    {
+        std::unique_ptr<juce::FileOutputStream> stream (tempFile.createOutputStream());
+        if (stream == nullptr || ! stream->openedOk())
+            return false;
+
+        // Bitová hloubka zdroje - v SampleStorage::Native se výsledek načte stejně kompaktně jako nahrané noty
+        const int bitsPerSample = source.format == SampleFormat::Compressed ? SampleCodec::getBitsPerSample (source.channelData[0])
+                                : source.format == SampleFormat::Int16 ? 16 : (source.format == SampleFormat::Int24 ? 24 : 32);
+
+        juce::WavAudioFormat wavFormat;
+        std::unique_ptr<juce::AudioFormatWriter> writer (wavFormat.createWriterFor (stream.get(), source.sampleRate,
+                                                                                   (unsigned int) output.getNumChannels(),
+                                                                                   bitsPerSample, {}, 0));
+        if (writer == nullptr)
+            return false;
+
+        stream.release();   // Vlastní ho writer
+
+        if (! writer->writeFromAudioSampleBuffer (output, 0, numOutput))
+        {
+            writer.reset();
+            tempFile.deleteFile();
+            return false;
+        }
+    }
+
+    if (! tempFile.moveFileTo (target))
+    {
+        tempFile.deleteFile();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Windowed-sinc převzorkování jednoho kanálu: output[i] = input(i * ratio).
+ */
+void SampleGenerator::resample (const float* input, int numInput, float* output, int numOutput,
+                                double ratio, const std::vector<float>& kernel, double resolution)
+{
+    const int halfTaps = (int) ((double) (kernel.size() - 2) / resolution) + 1;
+    const int lastKernelIndex = (int) kernel.size() - 2;
+
+    for (int i = 0; i < numOutput; ++i)
+    {
+        const double position = i * ratio;
+        const int centre = (int) position;
+        const int first = juce::jmax (0, centre - halfTaps + 1);
+        const int last = juce::jmin (numInput - 1, centre + halfTaps);
+
+        double sum = 0.0;
+        for (int k = first; k <= last; ++k)
+        {
+            const double t = std::abs (position - k) * resolution;
+            const int index = (int) t;
+            if (index > lastKernelIndex)
+                continue;
+
+            const float frac = (float) (t - index);
+            sum += input[k] * (kernel[(size_t) index] + frac * (kernel[(size_t) index + 1] - kernel[(size_t) index]));
+        }
+
+        output[i] = (float) sum;
+    }
+}
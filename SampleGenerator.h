@@ -0,0 +1,70 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <memory>
+#include <vector>
+#include "SampleLibrary.h"
+#include "SamplerSettings.h"
+
+/**
+ * Třída SampleGenerator - dopočítání chybějících not pitch-shiftem (DESIGN.md, "SampleGenerator").
+ *
+ * Každá chybějící nota v rozsahu MIDI_NOTE_MIN..MIDI_NOTE_MAX se vytvoří
+ * převzorkováním nejbližší nahrané noty (±MAX_PITCH_SHIFT půltónů), jedna
+ * úloha na každý vzorek zdrojové noty (velocity vrstva / varianta). Délka
+ * se mění s výškou, stejně jako u skutečného piana.
+ *
+ * Převzorkování je windowed-sinc (Kaiser) s antialiasingem při posunu nahoru.
+ * Výsledky jsou WAV soubory v samples_tmp/generated adresované obsahem:
+ * klíč je hash bajtů zdrojového souboru (a jeho názvu), posunu a parametrů
+ * resampleru, takže přenahraný vzorek se stejným názvem, velikostí i časem
+ * změny se vygeneruje znovu. Druhý a další start generování přeskočí (jen
+ * přečte zdroje kvůli hashi). Jméno začíná hashem adresáře vzorků; po
+ * dokončeném běhu se smažou výsledky téhož adresáře, které běh nepoužil
+ * (starší klíče, noty, které už jsou nahrané).
+ */
+class SampleGenerator
+{
+public:
+    // Parametry resampleru - jejich změna mění klíče cache
+    static constexpr int sincZeroCrossings = 32;
+    static constexpr double kaiserBeta = 9.0;
+    static constexpr double cutoff = 0.95;      // Vůči Nyquistově frekvenci cíle
+
+    struct Task
+    {
+        std::shared_ptr<const SampleData> source;
+        int targetNote = -1;
+    };
+
+    /**
+     * Naplánování úloh pro noty bez nahraného vzorku.
+     */
+    static std::vector<Task> planMissingNotes (const std::vector<std::shared_ptr<const SampleData>>& recorded);
+
+    /**
+     * Vygenerování (nebo převzetí z cache) všech úloh a načtení výsledků podle
+     * settings (v DFD režimu jen rezidentní hlavička). Volat mimo audio vlákno;
+     * s poolem běží jedna úloha na job. Při zrušení přes progress vrací prázdný vektor.
+     */
+    static std::vector<std::shared_ptr<const SampleData>> generate (const std::vector<Task>& tasks, const SamplerSettings& settings,
+                                                                    juce::ThreadPool* pool, SampleLoadProgress* progress);
+
+    // Soubor cache pro daný zdroj (contentHash = hashFileContent zdroje) a cílovou notu
+    static juce::File getCacheFileFor (const SampleData& source, juce::uint64 contentHash, int targetNote);
+
+    // Hash bajtů souboru (0 = soubor nejde číst)
+    static juce::uint64 hashFileContent (const juce::File& file);
+
+private:
+    static std::shared_ptr<const SampleData> runTask (const Task& task, const juce::File& cacheFile, const SamplerSettings& settings,
+                                                      juce::AudioFormatManager& formatManager);
+    static juce::String getDirectoryPrefix (const juce::File& sampleDirectory);
+    static void removeStaleFiles (const std::vector<Task>& tasks, const std::vector<juce::File>& usedFiles);
+    static bool readSource (const SampleData& source, juce::AudioBuffer<float>& destination,
+                            juce::AudioFormatManager& formatManager);
+    static bool renderToFile (const SampleData& source, const juce::AudioBuffer<float>& input,
+                              double ratio, const juce::File& target);
+    static void resample (const float* input, int numInput, float* output, int numOutput,
+                          double ratio, const std::vector<float>& kernel, double kernelResolution);
+};
@@ -0,0 +1,581 @@
+#include "SampleLibrary.h"
+#include "SampleCache.h"
+#include "SampleCodec.h"
+#include "Logger.h"
+
+/**
+ * Rozparsování názvu souboru mNNN-NOTA-DbLvl-X[-V].wav.
+ */
+bool SampleFileInfo::parseFileName (const juce::File& file, SampleFileInfo& result)
+{
+    if (! file.hasFileExtension ("wav"))
+        return false;
+
+    juce::StringArray tokens;
+    tokens.addTokens (file.getFileNameWithoutExtension(), "-", "");
+
+    if (tokens.size() < 4 || tokens.size() > 5)
+        return false;
+
+    const auto& noteToken = tokens[0];
+    if (noteToken.length() != 4 || ! noteToken.startsWithIgnoreCase ("m")
+        || ! noteToken.substring (1).containsOnly ("0123456789"))
+        return false;
+
+    if (! tokens[2].equalsIgnoreCase ("DbLvl") || ! tokens[3].containsOnly ("0123456789"))
+        return false;
+
+    const int note = noteToken.substring (1).getIntValue();
+    if (! juce::isPositiveAndBelow (note, 128))
+        return false;
+
+    int variant = 0;
+    if (tokens.size() == 5)
+    {
+        if (! tokens[4].containsOnly ("0123456789"))
+            return false;
+
+        variant = tokens[4].getIntValue();
+    }
+
+    result.file = file;
+    result.midiNote = note;
+    result.noteName = tokens[1];
+    result.dbLevel = -std::abs (tokens[3].getIntValue());
+    result.variant = variant;
+    return true;
+}
+
+//==============================================================================
+SampleLibrary::SampleLibrary()
+    : velocityTable (128 * 128)
+{
+}
+
+SampleLibrary::~SampleLibrary() = default;
+
+std::unique_ptr<SampleLibrary> SampleLibrary::createFromSamples (const juce::File& dir, juce::uint64 dirFingerprint,
+                                                                 std::vector<std::shared_ptr<const SampleData>> sharedSamples)
+{
+    auto library = std::make_unique<SampleLibrary>();
+    library->directory = dir;
+    library->fingerprint = dirFingerprint;
+    library->samples = std::move (sharedSamples);
+    library->buildNoteMap();
+    return library;
+}
+
+/**
+ * Načtení nástroje z adresáře. Pokud existuje platná cache, jen se namapuje;
+ * jinak se WAV soubory dekódují (paralelně, je-li k dispozici pool)
+ * a cache se pro příští start zapíše.
+ */
+bool SampleLibrary::loadFromDirectory (const juce::File& dir, const SamplerSettings& settings,
+                                       juce::ThreadPool* pool, SampleLoadProgress* progress)
+{
+    directory = dir;
+    samples.clear();
+    mappedCache.reset();
+
+    SampleLoadProgress localProgress;
+    if (progress == nullptr)
+        progress = &localProgress;
+
+    if (! dir.isDirectory())
+    {
+        ITHACA_LOG_WARN ("SampleLibrary/loadFromDirectory", 
+            "Adresar vzorku neexistuje: " + dir.getFullPathName());
+        fingerprint = 0;
+        buildNoteMap();
+        return false;
+    }
+
+    // Sken a parsování názvů (levné, sekvenčně); seřazeno kvůli deterministickému pořadí
+    auto files = dir.findChildFiles (juce::File::findFiles, false, "*.wav");
+    std::sort (files.begin(), files.end(), [] (const juce::File& a, const juce::File& b)
+    {
+        return a.getFileName() < b.getFileName();
+    });
+
+    std::vector<SampleFileInfo> infos;
+    juce::int64 totalBytes = 0;
+
+    for (const auto& file : files)
+    {
+        SampleFileInfo info;
+        if (! SampleFileInfo::parseFileName (file, info))
+        {
+            ITHACA_LOG_DEBUG ("SampleLibrary/loadFromDirectory", 
+                "Preskocen soubor s neplatnym nazvem: " + file.getFileName());
+            continue;
+        }
+
+        totalBytes += file.getSize();
+        infos.push_back (info);
+    }
+
+    progress->filesTotal = (int) infos.size();
+    progress->bytesTotal = totalBytes;
+
+    fingerprint = computeFingerprint (dir);
+
+    // Cache se nepoužívá v DFD režimu - ten čte přímo původní WAV soubory
+    const bool useCache = settings.useSampleCache && ! settings.streamFromDisk;
+    const auto floatCacheFormat = settings.sampleStorage == SampleStorage::Compact16 ? SampleFormat::Int16 : SampleFormat::Float32;
+    const auto cacheKey = fingerprint ^ ((juce::uint64) settings.sampleStorage << 56);
+    const auto cacheFile = SampleCache::getCacheFileFor (dir);
+
+    if (useCache)
+    {
+        if (loadFromCache (cacheFile, cacheKey))
+        {
+            progress->filesDone = progress->filesTotal.load();
+            progress->bytesDone = totalBytes;
+            return true;
+        }
+
+        // Neplatná nebo zastaralá cache - smazání a přestavba (DESIGN7.md, "Zpracování chyb")
+        if (cacheFile.existsAsFile())
+            cacheFile.deleteFile();
+    }
+
+    // Dekódování - každý soubor zapisuje jen do svého slotu ve výsledcích
+    std::vector<std::unique_ptr<SampleData>> decoded (infos.size());
+    std::atomic<int> numFailed { 0 };
+
+    auto decodeFile = [&, progress] (size_t index, juce::AudioFormatManager& formatManager)
+    {
+        if (progress->cancelled.load (std::memory_order_relaxed))
+            return;
+
+        const auto& info = infos[index];
+        decoded[index] = loadSample (formatManager, info, settings);
+
+        if (decoded[index] == nullptr)
+            ++numFailed;
+
+        progress->bytesDone += info.file.getSize();
+        ++progress->filesDone;
+    };
+
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    if (pool != nullptr && infos.size() > 1)
+    {
+        std::atomic<int> remaining { (int) infos.size() };
+        juce::WaitableEvent allDone;
+
+        for (size_t i = 0; i < infos.size(); ++i)
+        {
+            pool->addJob ([&, i]
+            {
+                juce::AudioFormatManager formatManager;
+                formatManager.registerBasicFormats();
+                decodeFile (i, formatManager);
+
+                if (--remaining == 0)
+                    allDone.signal();
+            });
+        }
+
+        // Zrušené joby skončí hned na začátku, čekání je tedy krátké
+        allDone.wait();
+    }
+    else
+    {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        for (size_t i = 0; i < infos.size(); ++i)
+            decodeFile (i, formatManager);
+    }
+
+    if (progress->cancelled.load())
+    {
+        ITHACA_LOG_INFO ("SampleLibrary/loadFromDirectory", "Nacitani vzorku zruseno");
+        samples.clear();
+        buildNoteMap();
+        return false;
+    }
+
+    for (auto& sample : decoded)
+        if (sample != nullptr)
+            samples.push_back (std::move (sample));
+
+    ITHACA_LOG_INFO ("SampleLibrary/loadFromDirectory", 
+        "Nacteno " + juce::String (getNumSamples()) + " vzorku (" + juce::String (numFailed.load()) + " chyb) za "
+        + juce::String ((juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0, 2) + " s, pamet: "
+        + juce::String ((double) getMemoryUsageBytes() / (1024.0 * 1024.0), 1) + " MB");
+
+    // Zápis cache a přepnutí na namapovaná data (dekódované buffery se uvolní)
+    if (useCache && numFailed == 0 && ! samples.empty())
+    {
+        std::vector<const SampleData*> toWrite;
+        for (const auto& sample : samples)
+            toWrite.push_back (sample.get());
+
+        if (SampleCache::write (cacheFile, toWrite, cacheKey, floatCacheFormat) && loadFromCache (cacheFile, cacheKey))
+            return true;
+    }
+
+    buildNoteMap();
+    return ! samples.empty();
+}
+
+/**
+ * Namapování cache kontejneru - čte se jen index, PCM zůstává na disku/v page cache.
+ */
+bool SampleLibrary::loadFromCache (const juce::File& cacheFile, juce::uint64 cacheKey)
+{
+    auto cache = std::make_unique<SampleCache>();
+    if (! cache->open (cacheFile, cacheKey))
+        return false;
+
+    mappedCache = std::move (cache);
+
+    // Každý vzorek drží mapování naživu - sdílí se i s rozšířenými instancemi nástroje
+    samples.clear();
+    for (auto& sample : mappedCache->createSamples (directory))
+    {
+        sample->storage = mappedCache;
+        samples.push_back (std::move (sample));
+    }
+    buildNoteMap();
+
+    ITHACA_LOG_INFO ("SampleLibrary/loadFromCache", 
+        "Nastroj namapovan z cache: " + juce::String (getNumSamples()) + " vzorku, "
+        + juce::String ((double) mappedCache->getMappedSize() / (1024.0 * 1024.0), 1) + " MB");
+
+    return ! samples.empty();
+}
+
+juce::uint64 SampleLibrary::computeFingerprint (const juce::File& dir)
+{
+    auto files = dir.findChildFiles (juce::File::findFiles, false, "*.wav");
+    std::sort (files.begin(), files.end(), [] (const juce::File& a, const juce::File& b)
+    {
+        return a.getFileName() < b.getFileName();
+    });
+
+    // FNV-1a přes název, velikost a čas změny každého platného vzorku
+    juce::uint64 hash = 14695981039346656037ull;
+    auto mix = [&hash] (juce::uint64 value)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            hash ^= (value >> (i * 8)) & 0xff;
+            hash *= 1099511628211ull;
+        }
+    };
+
+    for (const auto& file : files)
+    {
+        SampleFileInfo info;
+        if (! SampleFileInfo::parseFileName (file, info))
+            continue;
+
+        mix ((juce::uint64) file.getFileName().hashCode64());
+        mix ((juce::uint64) file.getSize());
+        mix ((juce::uint64) file.getLastModificationTime().toMilliseconds());
+    }
+
+    return hash;
+}
+
+std::unique_ptr<SampleData> SampleLibrary::loadSample (juce::AudioFormatManager& formatManager, const SampleFileInfo& info,
+                                                       const SamplerSettings& settings)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader (formatManager.createReaderFor (info.file));
+
+    if (reader == nullptr || reader->lengthInSamples <= 0 || reader->lengthInSamples >= std::numeric_limits<int>::max())
+    {
+        ITHACA_LOG_ERROR ("SampleLibrary/loadSample", 
+            "Nelze nacist vzorek: " + info.file.getFileName());
+        return nullptr;
+    }
+
+    auto sample = std::make_unique<SampleData>();
+    sample->file = info.file;
+    sample->midiNote = info.midiNote;
+    sample->dbLevel = info.dbLevel;
+    sample->variant = info.variant;
+    sample->sampleRate = reader->sampleRate;
+    sample->numFrames = (int) reader->lengthInSamples;
+    sample->residentFrames = sample->numFrames;
+
+    if (settings.streamFromDisk)
+    {
+        const auto preloadFrames = (int) (reader->sampleRate * settings.preloadMilliseconds / 1000.0);
+        sample->residentFrames = juce::jlimit (1, sample->numFrames, preloadFrames);
+    }
+
+    // Streamovaný vzorek: guard frame je skutečný frame ze souboru (navazuje na ring)
+    const int framesToRead = sample->isStreamed() ? sample->residentFrames + 1 : sample->numFrames;
+
+    sample->numChannels = juce::jlimit (1, 2, (int) reader->numChannels);
+
+    // Celočíselný WAV bez ztráty v původní bitové hloubce (jen plně rezidentní vzorky)
+    const bool integerStorage = settings.sampleStorage == SampleStorage::Native
+                             || settings.sampleStorage == SampleStorage::Compressed;
+
+    if (integerStorage && ! sample->isStreamed() && ! reader->usesFloatingPointData && reader->bitsPerSample <= 24)
+    {
+        if (settings.sampleStorage == SampleStorage::Compressed && readCompressedPcm (*reader, *sample))
+            return sample;
+
+        if (! readNativePcm (*reader, *sample, reader->bitsPerSample <= 16 ? SampleFormat::Int16 : SampleFormat::Int24))
+        {
+            ITHACA_LOG_ERROR ("SampleLibrary/loadSample", 
+                "Chyba pri dekodovani vzorku: " + info.file.getFileName());
+            return nullptr;
+        }
+
+        return sample;
+    }
+
+    sample->ownedAudio.setSize (sample->numChannels, sample->residentFrames + 1);
+    sample->ownedAudio.clear();
+
+    if (! reader->read (&sample->ownedAudio, 0, framesToRead, 0, true, sample->numChannels > 1))
+    {
+        ITHACA_LOG_ERROR ("SampleLibrary/loadSample", 
+            "Chyba pri dekodovani vzorku: " + info.file.getFileName());
+        return nullptr;
+    }
+
+    for (int channel = 0; channel < sample->numChannels; ++channel)
+        sample->channelData[channel] = sample->ownedAudio.getReadPointer (channel);
+
+    return sample;
+}
+
+/**
+ * Čtení celého vzorku do ownedPcm v daném celočíselném formátu (+ nulový guard).
+ * Reader vrací int32 zarovnané doleva, takže posun zachová původní bity
+ * 16bit i 24bit souboru. Čte se po blocích, plný int32 buffer nevzniká.
+ */
+bool SampleLibrary::readNativePcm (juce::AudioFormatReader& reader, SampleData& sample, SampleFormat format)
+{
+    constexpr int framesPerBlock = 8192;
+
+    const auto bytesPerSample = getBytesPerSample (format);
+    const auto channelBytes = (size_t) (sample.numFrames + 1) * bytesPerSample;
+
+    sample.ownedPcm.setSize (channelBytes * (size_t) sample.numChannels, true);
+    sample.format = format;
+    sample.scale = format == SampleFormat::Int16 ? 1.0f / 32768.0f : 1.0f / 8388608.0f;
+
+    juce::HeapBlock<int> blockData ((size_t) framesPerBlock * 2);
+    int* const blockChannels[2] = { blockData.get(), blockData.get() + framesPerBlock };
+    auto* base = static_cast<juce::uint8*> (sample.ownedPcm.getData());
+
+    for (int start = 0; start < sample.numFrames; start += framesPerBlock)
+    {
+        const int numFrames = juce::jmin (framesPerBlock, sample.numFrames - start);
+        if (! reader.read (blockChannels, sample.numChannels, start, numFrames, false))
+            return false;
+
+        for (int channel = 0; channel < sample.numChannels; ++channel)
+        {
+            const int* in = blockChannels[channel];
+            auto* out = base + channelBytes * (size_t) channel + (size_t) start * bytesPerSample;
+
+            if (format == SampleFormat::Int16)
+            {
+                auto* out16 = reinterpret_cast<juce::int16*> (out);
+                for (int i = 0; i < numFrames; ++i)
+                    out16[i] = (juce::int16) (in[i] >> 16);
+            }
+            else
+            {
+                for (int i = 0; i < numFrames; ++i, out += 3)
+                {
+                    const auto value = (juce::uint32) in[i] >> 8;
+                    out[0] = (juce::uint8) value;
+                    out[1] = (juce::uint8) (value >> 8);
+                    out[2] = (juce::uint8) (value >> 16);
+                }
+            }
+        }
+    }
+
+    for (int channel = 0; channel < sample.numChannels; ++channel)
+        sample.channelData[channel] = base + channelBytes * (size_t) channel;
+
+    return true;
+}
+
+/**
+ * Bezeztrátová komprese celého vzorku do ownedPcm (SampleCodec). Vrací false,
+ * pokud čtení selže nebo komprese neušetří místo proti nativnímu PCM -
+ * vzorek se pak načte nekomprimovaný (readNativePcm).
+ */
+bool SampleLibrary::readCompressedPcm (juce::AudioFormatReader& reader, SampleData& sample)
+{
+    const int bitsPerSample = reader.bitsPerSample <= 16 ? 16 : 24;
+
+    juce::HeapBlock<int> pcm ((size_t) sample.numFrames * (size_t) sample.numChannels);
+    int* const channels[2] = { pcm.get(), pcm.get() + (sample.numChannels > 1 ? sample.numFrames : 0) };
+
+    if (! reader.read (channels, sample.numChannels, 0, sample.numFrames, false))
+        return false;
+
+    // Reader vrací int32 zarovnané doleva, kodek pracuje s hodnotami zarovnanými doprava
+    for (int channel = 0; channel < sample.numChannels; ++channel)
+        for (int i = 0; i < sample.numFrames; ++i)
+            channels[channel][i] >>= 32 - bitsPerSample;
+
+    auto encoded = SampleCodec::encode (channels, sample.numChannels, sample.numFrames, bitsPerSample);
+    const auto nativeBytes = (size_t) (sample.numFrames + 1) * (size_t) (bitsPerSample / 8) * (size_t) sample.numChannels;
+
+    if (encoded.isEmpty() || encoded.getSize() >= nativeBytes)
+        return false;
+
+    sample.ownedPcm = std::move (encoded);
+    sample.format = SampleFormat::Compressed;
+    sample.scale = bitsPerSample == 16 ? 1.0f / 32768.0f : 1.0f / 8388608.0f;
+    sample.channelData[0] = sample.ownedPcm.getData();
+    sample.channelData[1] = sample.ownedPcm.getData();
+    return true;
+}
+
+/**
+ * Sestavení mapy nota -> velocity vrstvy, včetně mapování chybějících not
+ * na nejbližší nahranou notu (max ±MAX_PITCH_SHIFT půltónů). Vzorky noty
+ * se stejným dB tvoří jednu vrstvu se skupinou variant.
+ */
+void SampleLibrary::buildNoteMap()
+{
+    for (auto& mapping : noteMap)
+        mapping = NoteMapping();
+
+    variantGroups.clear();
+    variantSamples.clear();
+    variantSamples.reserve (samples.size());
+
+    std::array<std::vector<int>, 128> noteSamples;
+    for (int i = 0; i < (int) samples.size(); ++i)
+        noteSamples[(size_t) samples[(size_t) i]->midiNote].push_back (i);
+
+    for (int note = 0; note < 128; ++note)
+    {
+        auto& indices = noteSamples[(size_t) note];
+        std::sort (indices.begin(), indices.end(), [this] (int a, int b)
+        {
+            const auto& sa = *samples[(size_t) a];
+            const auto& sb = *samples[(size_t) b];
+            return sa.dbLevel != sb.dbLevel ? sa.dbLevel < sb.dbLevel : sa.variant < sb.variant;
+        });
+
+        // Vrstva = souvislý úsek se stejným dB
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            if (i == 0 || samples[(size_t) indices[i]]->dbLevel != samples[(size_t) indices[i - 1]]->dbLevel)
+            {
+                noteMap[(size_t) note].layers.push_back ((int) variantGroups.size());
+                variantGroups.push_back ({ (int) variantSamples.size(), 0 });
+            }
+
+            variantSamples.push_back (indices[i]);
+            ++variantGroups.back().count;
+        }
+
+        if (! indices.empty())
+            noteMap[(size_t) note].sourceNote = note;
+    }
+
+    // Chybějící noty - nejbližší nahraná nota
+    for (int note = 0; note < 128; ++note)
+    {
+        auto& mapping = noteMap[(size_t) note];
+        if (mapping.sourceNote >= 0)
+            continue;
+
+        for (int distance = 1; distance <= IthacaConfig::MAX_PITCH_SHIFT; ++distance)
+        {
+            for (int candidate : { note - distance, note + distance })
+            {
+                if (juce::isPositiveAndBelow (candidate, 128) && noteMap[(size_t) candidate].sourceNote == candidate)
+                {
+                    mapping.sourceNote = candidate;
+                    mapping.pitchRatio = (float) std::pow (2.0, (note - candidate) / 12.0);
+                    break;
+                }
+            }
+
+            if (mapping.sourceNote >= 0)
+                break;
+        }
+    }
+
+    // Hustá tabulka nota x velocity - výběr vrstvy se při note-on už nepočítá
+    velocityTable.assign (128 * 128, VelocityMapping());
+
+    for (int note = 0; note < 128; ++note)
+    {
+        const auto& mapping = noteMap[(size_t) note];
+        if (mapping.sourceNote >= 0)
+            buildVelocityRow (noteMap[(size_t) mapping.sourceNote].layers, mapping.pitchRatio, &velocityTable[(size_t) note * 128]);
+    }
+}
+
+/**
+ * Řádek tabulky pro jednu notu. Velocity 0-127 se rozdělí rovnoměrně mezi
+ * vrstvy (vzestupně podle dB). Mezi středy sousedních vrstev se cílová
+ * hlasitost lineárně interpoluje v dB: gain dorovná vybranou vrstvu na cíl,
+ * váhy crossfade (equal-power) smíchají obě vrstvy. Pod středem nejslabší
+ * a nad středem nejsilnější vrstvy hraje vrstva beze změny.
+ */
+void SampleLibrary::buildVelocityRow (const std::vector<int>& layers, float pitchRatio, VelocityMapping* row) const
+{
+    const int numLayers = (int) layers.size();
+    if (numLayers == 0)
+        return;
+
+    constexpr int numVelocities = IthacaConfig::MIDI_VELOCITY_MAX + 1;
+    auto layerCentre = [numLayers] (int layer) { return (layer + 0.5) * numVelocities / numLayers - 0.5; };
+    auto layerDb = [this, &layers] (int layer)
+    {
+        return (double) samples[(size_t) variantSamples[(size_t) variantGroups[(size_t) layers[(size_t) layer]].first]]->dbLevel;
+    };
+
+    for (int velocity = 0; velocity < numVelocities; ++velocity)
+    {
+        auto& cell = row[velocity];
+        const int layer = juce::jlimit (0, numLayers - 1, velocity * numLayers / numVelocities);
+
+        cell.group = layers[(size_t) layer];
+        cell.pitchRatio = pitchRatio;
+
+        // Dvojice vrstev, mezi jejichž středy velocity leží
+        const int lower = (int) std::floor ((velocity + 0.5) * numLayers / numVelocities - 0.5);
+        if (lower < 0 || lower + 1 >= numLayers)
+            continue;
+
+        const double t = (velocity - layerCentre (lower)) / (layerCentre (lower + 1) - layerCentre (lower));
+        const double targetDb = layerDb (lower) + t * (layerDb (lower + 1) - layerDb (lower));
+        cell.gain = juce::Decibels::decibelsToGain ((float) (targetDb - layerDb (layer)));
+
+        const float lowerWeight = (float) std::cos (t * juce::MathConstants<double>::halfPi);
+        const float upperWeight = (float) std::sin (t * juce::MathConstants<double>::halfPi);
+        const int other = layer == lower ? lower + 1 : lower;
+        const float otherWeight = layer == lower ? upperWeight : lowerWeight;
+
+        if (otherWeight >= minCrossfadeWeight)
+        {
+            cell.crossfadeGroup = layers[(size_t) other];
+            cell.weight = layer == lower ? lowerWeight : upperWeight;
+            cell.crossfadeWeight = otherWeight;
+        }
+    }
+}
+
+size_t SampleLibrary::getMemoryUsageBytes() const noexcept
+{
+    size_t total = 0;
+    for (const auto& sample : samples)
+        total += (size_t) sample->ownedAudio.getNumChannels() * (size_t) sample->ownedAudio.getNumSamples() * sizeof (float)
+               + sample->ownedPcm.getSize();
+
+    return total;
+}
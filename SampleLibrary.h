@@ -0,0 +1,250 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "IthacaConfig.h"
+#include "SamplerSettings.h"
+
+/**
+ * Metadata vzorku získaná z názvu souboru ve formátu mNNN-NOTA-DbLvl-X.wav
+ * (např. m060-C_4-DbLvl-20.wav = MIDI nota 60, -20 dB).
+ * Volitelný pátý token je číslo varianty (m060-C_4-DbLvl-20-2.wav).
+ */
+struct SampleFileInfo
+{
+    juce::File file;
+    int midiNote = -1;
+    juce::String noteName;
+    int dbLevel = 0;        // Negativní nebo 0 (0 = plná hlasitost)
+    int variant = 0;
+
+    // Rozparsování názvu souboru; vrací false, pokud název neodpovídá konvenci
+    static bool parseFileName (const juce::File& file, SampleFileInfo& result);
+};
+
+/**
+ * Formát PCM dat vzorku v paměti.
+ */
+enum class SampleFormat : juce::uint8
+{
+    Float32 = 0,
+    Int16 = 1,      // float = int16 * SampleData::scale
+    Int24 = 2,      // Packed 3 bajty little-endian, float = int24 * SampleData::scale
+    Compressed = 3  // Bloky SampleCodec (oba kanály v jednom bloku dat), float = int * SampleData::scale
+};
+
+// Velikost jednoho vzorku kanálu v bajtech (nekomprimované formáty)
+inline size_t getBytesPerSample (SampleFormat format) noexcept
+{
+    return format == SampleFormat::Int16 ? 2 : (format == SampleFormat::Int24 ? 3 : 4);
+}
+
+/**
+ * Vzorek připravený k přehrávání.
+ * PCM data jsou planární a ukazují buď do vlastního bufferu (ownedAudio
+ * pro float32, ownedPcm pro int16 / packed int24 / komprimovaná data), nebo
+ * do namapovaného cache souboru (SampleCache). U SampleFormat::Compressed
+ * ukazují oba kanály na tentýž kódovaný blok (SampleCodec) a guard frame
+ * se při dekódování doplní nulou.
+ * Každý kanál má o jeden frame navíc (guard), aby interpolace nemusela
+ * kontrolovat poslední index. U plně načteného vzorku je guard nulový,
+ * u streamovaného (DFD) je to skutečný frame residentFrames ze souboru.
+ */
+struct SampleData
+{
+    juce::File file;
+    int midiNote = -1;
+    int dbLevel = 0;
+    int variant = 0;
+    double sampleRate = 44100.0;
+    int numFrames = 0;              // Celková délka vzorku
+    int residentFrames = 0;         // Počet framů v paměti (== numFrames, pokud se nestreamuje)
+    int numChannels = 0;
+    SampleFormat format = SampleFormat::Float32;
+    float scale = 1.0f;
+    bool generated = false;         // Dopočítán pitch-shiftem z nahrané noty (SampleGenerator)
+    const void* channelData[2] = { nullptr, nullptr };
+
+    // Vlastní dekódovaná data (prázdné, pokud vzorek leží v mmap cache)
+    juce::AudioBuffer<float> ownedAudio;
+    juce::MemoryBlock ownedPcm;     // Celočíselné formáty, kanály za sebou
+
+    // Drží naživu namapovanou cache, do které ukazuje channelData
+    std::shared_ptr<const void> storage;
+
+    int getNumChannels() const noexcept { return numChannels; }
+    bool isStreamed() const noexcept { return residentFrames < numFrames; }
+
+    // Data kanálu v daném formátu; mono vzorek vrací pro kanál 1 kanál 0
+    template <typename SampleType>
+    const SampleType* getChannel (int channel) const noexcept
+    {
+        return static_cast<const SampleType*> (channelData[channel < numChannels ? channel : 0]);
+    }
+};
+
+/**
+ * Průběh načítání nástroje. Zapisují ho načítací vlákna, čte kdokoli
+ * (editor, loader) bez zámků. cancelled přeruší načítání mezi soubory.
+ */
+struct SampleLoadProgress
+{
+    std::atomic<int> filesTotal { 0 };
+    std::atomic<int> filesDone { 0 };
+    std::atomic<juce::int64> bytesTotal { 0 };
+    std::atomic<juce::int64> bytesDone { 0 };
+    std::atomic<bool> cancelled { false };
+
+    void reset() noexcept
+    {
+        filesTotal = 0;
+        filesDone = 0;
+        bytesTotal = 0;
+        bytesDone = 0;
+    }
+};
+
+/**
+ * Předpočítaný výběr vzorku pro notu a velocity (buňka tabulky 128 x 128).
+ *
+ * group je vrstva podle rovnoměrného rozdělení velocity (skupina variant
+ * se stejným dB, viz SampleLibrary::getVariantSample); gain vyrovnává
+ * hlasitost uvnitř vrstvy tak, aby plynule navazovala na sousední dB vrstvy.
+ * Pro crossfade je připravena sousední vrstva s dvojicí vah (equal-power);
+ * engine ji použije jen se zapnutým crossfade, jinak hraje group s gain.
+ */
+struct VelocityMapping
+{
+    int group = -1;                 // Skupina variant vrstvy, -1 = nota nemá vzorek
+    int crossfadeGroup = -1;        // Sousední vrstva pro crossfade, -1 = bez crossfade
+    float pitchRatio = 1.0f;        // Poměr výšky vůči nahrané notě
+    float gain = 1.0f;              // Kompenzace hlasitosti (vrstva hraje sama)
+    float weight = 1.0f;            // Crossfade: váha group
+    float crossfadeWeight = 0.0f;   // Crossfade: váha crossfadeGroup
+};
+
+class SampleCache;
+
+/**
+ * Třída SampleLibrary - nahraný nástroj (sada vzorků mNNN-NOTA-DbLvl-X.wav).
+ *
+ * Po načtení je neměnná a audio vlákno z ní pouze čte. Pro každou MIDI notu
+ * drží seznam velocity vrstev seřazených podle dB (viz DESIGN7.md,
+ * "Dynamické mapování velocity"), ze kterého se při načtení sestaví hustá
+ * tabulka 128 not x 128 velocity (VelocityMapping) - note-on je jediné
+ * čtení z pole. Vzorky stejné noty a dB lišící se jen variantou (pátý token
+ * názvu) tvoří skupinu pro round-robin / náhodný výběr; výběr je jen index
+ * do plochého pole. Chybějící noty se mapují na nejbližší
+ * nahranou notu v rozsahu ±MAX_PITCH_SHIFT půltónů s příslušným poměrem výšky,
+ * dokud je SampleGenerator nedopočítá (pak vzniká nová instance s createFromSamples).
+ * Vzorky jsou sdílené, takže rozšířený nástroj nekopíruje PCM data.
+ *
+ * V DFD režimu (SamplerSettings::streamFromDisk) se do paměti načte jen
+ * prvních preloadMilliseconds každého vzorku, zbytek streamuje SampleStreamer.
+ * Jinak se nástroj načítá z namapovaného cache kontejneru (SampleCache);
+ * WAV soubory se dekódují jen při prvním startu nebo po změně adresáře.
+ */
+class SampleLibrary
+{
+public:
+    SampleLibrary();
+    ~SampleLibrary();
+
+    /**
+     * Načtení všech vzorků z adresáře (volat mimo audio vlákno).
+     * S thread poolem se soubory dekódují paralelně (jeden job na soubor);
+     * progress (volitelný) hlásí průběh a umožňuje načítání zrušit.
+     * Zrušené načítání vrací false a nezapisuje cache.
+     */
+    bool loadFromDirectory (const juce::File& directory, const SamplerSettings& settings,
+                            juce::ThreadPool* pool = nullptr, SampleLoadProgress* progress = nullptr);
+
+    /**
+     * Výběr vzorku pro notu a velocity z předpočítané tabulky. Real-time safe.
+     * Nota a velocity se ořezávají do 0-127; bez vzorku je mapping.group -1.
+     */
+    const VelocityMapping& getVelocityMapping (int midiNote, int velocity) const noexcept
+    {
+        return velocityTable[(size_t) ((midiNote & 0x7f) * 128 + (velocity & 0x7f))];
+    }
+
+    // Počet variant ve skupině a vzorek varianty choice (modulo počet, takže stačí libovolný čítač)
+    int getNumVariants (int group) const noexcept { return variantGroups[(size_t) group].count; }
+
+    const SampleData& getVariantSample (int group, juce::uint32 choice) const noexcept
+    {
+        const auto& variantGroup = variantGroups[(size_t) group];
+        return *samples[(size_t) variantSamples[(size_t) variantGroup.first + choice % (juce::uint32) variantGroup.count]];
+    }
+
+    /**
+     * Nástroj ze sady již načtených vzorků (např. nahrané + vygenerované noty).
+     * Vzorky se sdílí s původním nástrojem, kopírují se jen ukazatele.
+     */
+    static std::unique_ptr<SampleLibrary> createFromSamples (const juce::File& directory, juce::uint64 fingerprint,
+                                                             std::vector<std::shared_ptr<const SampleData>> samples);
+
+    // Sdílené vzorky nástroje (pro generátor a rozšířené instance)
+    const std::vector<std::shared_ptr<const SampleData>>& getSamples() const noexcept { return samples; }
+
+    int getNumSamples() const noexcept { return (int) samples.size(); }
+    const juce::File& getDirectory() const noexcept { return directory; }
+    juce::uint64 getFingerprint() const noexcept { return fingerprint; }
+    bool isLoadedFromCache() const noexcept { return mappedCache != nullptr; }
+
+    // Paměť dekódovaných dat (bez namapované cache)
+    size_t getMemoryUsageBytes() const noexcept;
+
+    /**
+     * Dekódování jednoho vzorku do paměti (+ guard frame). Se SampleStorage::Native
+     * zůstanou 16bit a 24bit celočíselné WAV v původní bitové hloubce, se
+     * SampleStorage::Compressed se navíc bezeztrátově zkomprimují (pokud to ušetří místo),
+     * jinak float32.
+     * V DFD režimu se načte jen rezidentní začátek vzorku (vždy float32).
+     */
+    static std::unique_ptr<SampleData> loadSample (juce::AudioFormatManager& formatManager, const SampleFileInfo& info,
+                                                   const SamplerSettings& settings);
+
+    /**
+     * Otisk adresáře vzorků (názvy, velikosti a časy změn platných WAV souborů).
+     * Levný - nečte audio data, jen metadata souborového systému.
+     */
+    static juce::uint64 computeFingerprint (const juce::File& directory);
+
+private:
+    static bool readNativePcm (juce::AudioFormatReader& reader, SampleData& sample, SampleFormat format);
+    static bool readCompressedPcm (juce::AudioFormatReader& reader, SampleData& sample);
+    bool loadFromCache (const juce::File& cacheFile, juce::uint64 cacheKey);
+    void buildNoteMap();
+    void buildVelocityRow (const std::vector<int>& layers, float pitchRatio, VelocityMapping* row) const;
+
+    // Crossfade se slabší vrstvou pod touto vahou by jen zbytečně zabral hlas
+    static constexpr float minCrossfadeWeight = 0.02f;
+
+    struct NoteMapping
+    {
+        int sourceNote = -1;        // Nahraná nota, ze které se hraje (-1 = žádná)
+        float pitchRatio = 1.0f;    // Poměr výšky vůči sourceNote
+        std::vector<int> layers;    // Skupiny variant, vzestupně podle dB
+    };
+
+    struct VariantGroup
+    {
+        int first = 0;              // Začátek ve variantSamples
+        int count = 0;
+    };
+
+    juce::File directory;
+    juce::uint64 fingerprint = 0;
+    std::shared_ptr<SampleCache> mappedCache;
+    std::vector<std::shared_ptr<const SampleData>> samples;
+    std::array<NoteMapping, 128> noteMap;
+    std::vector<VariantGroup> variantGroups;
+    std::vector<int> variantSamples;                // Indexy do samples po skupinách, vzestupně podle varianty
+    std::vector<VelocityMapping> velocityTable;     // 128 not x 128 velocity
+
+    JUCE_DECLARE_NON_COPYABLE (SampleLibrary)
+};
@@ -0,0 +1,152 @@
+#include "SampleLibraryLoader.h"
+#include "SampleGenerator.h"
+#include "Logger.h"
+
+SampleLibraryLoader::SampleLibraryLoader (LoadedCallback callback)
+    : juce::Thread ("IthacaPlayer Library Loader"),
+      onLoaded (std::move (callback)),
+      pool (juce::jmax (1, juce::SystemStats::getNumCpus()), 0, juce::Thread::Priority::low)
+{
+    startThread (juce::Thread::Priority::low);
+}
+
+SampleLibraryLoader::~SampleLibraryLoader()
+{
+    cancel();
+    stopThread (10000);
+}
+
+void SampleLibraryLoader::startLoad (const SamplerSettings& settings)
+{
+    {
+        const juce::ScopedLock sl (requestLock);
+        requestedSettings = settings;
+        hasRequest = true;
+        progress.cancelled = true;
+        loading = true;
+    }
+
+    ITHACA_LOG_INFO ("SampleLibraryLoader/startLoad", 
+        "Pozadavek na nacteni nastroje: " + settings.sampleDirectory.getFullPathName());
+    notify();
+}
+
+void SampleLibraryLoader::cancel()
+{
+    const juce::ScopedLock sl (requestLock);
+    hasRequest = false;
+    progress.cancelled = true;
+}
+
+bool SampleLibraryLoader::waitUntilIdle (int timeoutMs) const
+{
+    const auto deadline = juce::Time::getMillisecondCounter() + (juce::uint32) juce::jmax (0, timeoutMs);
+
+    while (loading.load())
+    {
+        if (juce::Time::getMillisecondCounter() >= deadline)
+            return false;
+
+        juce::Thread::sleep (5);
+    }
+
+    return true;
+}
+
+SampleLibraryLoader::Progress SampleLibraryLoader::getProgress() const noexcept
+{
+    Progress result;
+    result.filesDone = progress.filesDone.load (std::memory_order_relaxed);
+    result.filesTotal = progress.filesTotal.load (std::memory_order_relaxed);
+    result.bytesDone = progress.bytesDone.load (std::memory_order_relaxed);
+    result.bytesTotal = progress.bytesTotal.load (std::memory_order_relaxed);
+    result.loading = loading.load (std::memory_order_relaxed);
+    return result;
+}
+
+/**
+ * Koordinační smyčka: převzetí požadavku, načtení, předání hotového nástroje.
+ */
+void SampleLibraryLoader::run()
+{
+    while (! threadShouldExit())
+    {
+        SamplerSettings settings;
+        bool hasWork = false;
+
+        {
+            const juce::ScopedLock sl (requestLock);
+
+            if (hasRequest)
+            {
+                settings = requestedSettings;
+                hasRequest = false;
+                hasWork = true;
+                progress.reset();
+                progress.cancelled = false;
+            }
+            else
+            {
+                loading = false;
+            }
+        }
+
+        if (! hasWork)
+        {
+            wait (-1);
+            continue;
+        }
+
+        const auto startTime = juce::Time::getMillisecondCounterHiRes();
+        auto library = std::make_unique<SampleLibrary>();
+        library->loadFromDirectory (settings.sampleDirectory, settings, &pool, &progress);
+
+        // Zrušený (nebo mezitím nahrazený) nástroj se zahodí zde, mimo audio i message vlákno
+        if (progress.cancelled.load() || threadShouldExit())
+        {
+            ITHACA_LOG_INFO ("SampleLibraryLoader/run", "Nacitani nastroje zruseno");
+            continue;
+        }
+
+        ITHACA_LOG_INFO ("SampleLibraryLoader/run", 
+            "Nastroj nacten za " + juce::String ((juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0, 2)
+            + " s (" + juce::String (library->getNumSamples()) + " vzorku, "
+            + juce::String (pool.getNumThreads()) + " vlaken)");
+
+        // Nahrané noty hrají hned; chybějící se dopočítají a nástroj se pak vymění za rozšířený
+        const auto directory = library->getDirectory();
+        const auto fingerprint = library->getFingerprint();
+        auto samples = library->getSamples();
+
+        if (onLoaded != nullptr)
+            onLoaded (std::move (library));
+
+        if (settings.generateMissingNotes)
+            generateMissingNotes (settings, directory, fingerprint, std::move (samples));
+    }
+}
+
+/**
+ * Dopočítání chybějících not ze sdílených vzorků právě předaného nástroje.
+ */
+void SampleLibraryLoader::generateMissingNotes (const SamplerSettings& settings, const juce::File& directory,
+                                                juce::uint64 fingerprint, std::vector<std::shared_ptr<const SampleData>> samples)
+{
+    const auto tasks = SampleGenerator::planMissingNotes (samples);
+    if (tasks.empty() || progress.cancelled.load() || threadShouldExit())
+        return;
+
+    ITHACA_LOG_INFO ("SampleLibraryLoader/generateMissingNotes", 
+        "Generovani chybejicich not: " + juce::String ((int) tasks.size()) + " uloh");
+
+    progress.reset();
+    auto generated = SampleGenerator::generate (tasks, settings, &pool, &progress);
+
+    if (generated.empty() || progress.cancelled.load() || threadShouldExit())
+        return;
+
+    samples.insert (samples.end(), generated.begin(), generated.end());
+
+    if (onLoaded != nullptr)
+        onLoaded (SampleLibrary::createFromSamples (directory, fingerprint, std::move (samples)));
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <functional>
+#include <memory>
+#include "SampleLibrary.h"
+#include "SamplerSettings.h"
+
+/**
+ * Třída SampleLibraryLoader - načítání nástroje na pozadí.
+ *
+ * Koordinační vlákno převezme požadavek, naskenuje adresář a dekódování
+ * souborů rozdělí do juce::ThreadPool s počtem vláken podle jader CPU.
+ * Průběh (soubory a bajty) je v atomických čítačích, editor ho může
+ * kdykoli číst přes getProgress().
+ *
+ * startLoad() ani cancel() neblokují - rozpracované načítání se jen označí
+ * jako zrušené a koordinační vlákno ho opustí mezi soubory. Hotový nástroj
+ * předá callbacku onLoaded na koordinačním vlákně; zrušený se zahodí.
+ *
+ * Po předání nástroje se chybějící noty dopočítají (SampleGenerator) na
+ * stejném poolu a onLoaded se zavolá podruhé s rozšířeným nástrojem.
+ */
+class SampleLibraryLoader : private juce::Thread
+{
+public:
+    using LoadedCallback = std::function<void (std::unique_ptr<SampleLibrary>)>;
+
+    struct Progress
+    {
+        int filesDone = 0;
+        int filesTotal = 0;
+        juce::int64 bytesDone = 0;
+        juce::int64 bytesTotal = 0;
+        bool loading = false;
+
+        double getFraction() const noexcept
+        {
+            return bytesTotal > 0 ? (double) bytesDone / (double) bytesTotal
+                                  : (filesTotal > 0 ? (double) filesDone / (double) filesTotal : 0.0);
+        }
+    };
+
+    explicit SampleLibraryLoader (LoadedCallback onLoaded);
+    ~SampleLibraryLoader() override;
+
+    // Nové načítání s danými nastaveními; případné rozpracované se zruší
+    void startLoad (const SamplerSettings& settings);
+
+    // Zrušení rozpracovaného i čekajícího načítání
+    void cancel();
+
+    // Čekání na dokončení všech požadavků (mimo audio vlákno); false = timeout
+    bool waitUntilIdle (int timeoutMs) const;
+
+    bool isLoading() const noexcept { return loading.load(); }
+    Progress getProgress() const noexcept;
+
+private:
+    void run() override;
+    void generateMissingNotes (const SamplerSettings& settings, const juce::File& directory,
+                               juce::uint64 fingerprint, std::vector<std::shared_ptr<const SampleData>> samples);
+
+    LoadedCallback onLoaded;
+    juce::ThreadPool pool;
+
+    juce::CriticalSection requestLock;
+    SamplerSettings requestedSettings;
+    bool hasRequest = false;
+
+    SampleLoadProgress progress;
+    std::atomic<bool> loading { false };
+
+    JUCE_DECLARE_NON_COPYABLE (SampleLibraryLoader)
+};
@@ -0,0 +1,240 @@
+#include "SampleStreamer.h"
+
+SampleStreamer::~SampleStreamer()
+{
+    release();
+}
+
+/**
+ * Alokace slotů (ring buffer na hlas) a spuštění I/O vláken.
+ */
+void SampleStreamer::prepare (int numSlots, int requestedRingFrames, int numThreads)
+{
+    release();
+
+    ringFrames = juce::nextPowerOfTwo (juce::jmax (requestedRingFrames, maxReadChunkFrames * 2));
+    ringMask = ringFrames - 1;
+    numIoThreads = juce::jmax (1, numThreads);
+
+    for (int i = 0; i < numSlots; ++i)
+    {
+        auto slot = std::make_unique<Slot>();
+        slot->ring.setSize (2, ringFrames);
+        slot->ring.clear();
+        slots.push_back (std::move (slot));
+    }
+
+    startThreads();
+}
+
+void SampleStreamer::release()
+{
+    stopThreads();
+    slots.clear();
+    ringFrames = 0;
+    ringMask = 0;
+}
+
+/**
+ * Zastavení všech streamů tak, aby žádné I/O vlákno nedrželo ukazatel na vzorek
+ * (nutné před uvolněním nástroje).
+ */
+void SampleStreamer::stopAllAndWait()
+{
+    stopThreads();
+
+    for (auto& slot : slots)
+    {
+        slot->sample.store (nullptr, std::memory_order_relaxed);
+        slot->generation.store (slot->generation.load (std::memory_order_relaxed) + 1, std::memory_order_release);
+        slot->loadedGeneration = slot->generation.load (std::memory_order_relaxed);
+        slot->loadedSample = nullptr;
+        slot->reader.reset();
+        slot->writeEnd = 0;
+    }
+
+    if (! slots.empty())
+        startThreads();
+}
+
+bool SampleStreamer::waitForServicePass (int timeoutMs)
+{
+    // Průchod rozpracovaný v okamžiku volání se nepočítá - čeká se o jeden navíc
+    std::vector<juce::uint64> targets;
+    for (auto& thread : threads)
+        targets.push_back (thread->completedPasses.load (std::memory_order_acquire) + 2);
+
+    const auto deadline = juce::Time::getMillisecondCounter() + (juce::uint32) juce::jmax (0, timeoutMs);
+
+    for (size_t i = 0; i < threads.size(); ++i)
+    {
+        while (threads[i]->completedPasses.load (std::memory_order_acquire) < targets[i])
+        {
+            if (juce::Time::getMillisecondCounter() >= deadline)
+                return false;
+
+            juce::Thread::sleep (1);
+        }
+    }
+
+    return true;
+}
+
+void SampleStreamer::startThreads()
+{
+    for (int i = 0; i < numIoThreads; ++i)
+    {
+        threads.push_back (std::make_unique<IoThread> (*this, i));
+        threads.back()->startThread (juce::Thread::Priority::high);
+    }
+}
+
+void SampleStreamer::stopThreads()
+{
+    for (auto& thread : threads)
+        thread->signalThreadShouldExit();
+
+    for (auto& thread : threads)
+        thread->stopThread (2000);
+
+    threads.clear();
+}
+
+//==============================================================================
+juce::uint32 SampleStreamer::startStream (int slotIndex, const SampleData* sample) noexcept
+{
+    jassert (juce::isPositiveAndBelow (slotIndex, (int) slots.size()));
+    auto& slot = *slots[(size_t) slotIndex];
+
+    const auto generation = slot.generation.load (std::memory_order_relaxed) + 1;
+    slot.playhead.store (sample->residentFrames, std::memory_order_relaxed);
+    slot.sample.store (sample, std::memory_order_relaxed);
+    slot.generation.store (generation, std::memory_order_release);
+    return generation;
+}
+
+void SampleStreamer::stopStream (int slotIndex) noexcept
+{
+    jassert (juce::isPositiveAndBelow (slotIndex, (int) slots.size()));
+    auto& slot = *slots[(size_t) slotIndex];
+
+    slot.sample.store (nullptr, std::memory_order_relaxed);
+    slot.generation.store (slot.generation.load (std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void SampleStreamer::setPlayhead (int slotIndex, juce::int64 frame) noexcept
+{
+    slots[(size_t) slotIndex]->playhead.store (frame, std::memory_order_release);
+}
+
+juce::int64 SampleStreamer::getAvailableEnd (int slotIndex, juce::uint32 generation, juce::int64 residentFrames) const noexcept
+{
+    const auto value = slots[(size_t) slotIndex]->published.load (std::memory_order_acquire);
+
+    if ((value >> 48) != (generation & 0xffffu))
+        return residentFrames;
+
+    return (juce::int64) (value & ((juce::uint64 (1) << 48) - 1));
+}
+
+const float* SampleStreamer::getRingChannel (int slotIndex, int channel) const noexcept
+{
+    return slots[(size_t) slotIndex]->ring.getReadPointer (channel);
+}
+
+//==============================================================================
+void SampleStreamer::publish (Slot& slot, juce::uint32 generation, juce::int64 end) noexcept
+{
+    slot.published.store (((juce::uint64) (generation & 0xffffu) << 48) | (juce::uint64) end,
+                          std::memory_order_release);
+}
+
+/**
+ * Obsluha jednoho slotu I/O vláknem. Vrací true, pokud byla vykonána nějaká práce.
+ */
+bool SampleStreamer::serviceSlot (Slot& slot, juce::AudioFormatManager& formatManager)
+{
+    const auto generation = slot.generation.load (std::memory_order_acquire);
+
+    // Nový vzorek (nebo stop) - otevření readeru mimo audio vlákno
+    if (generation != slot.loadedGeneration)
+    {
+        slot.loadedGeneration = generation;
+        slot.loadedSample = slot.sample.load (std::memory_order_relaxed);
+        slot.reader.reset();
+
+        if (slot.loadedSample != nullptr)
+        {
+            slot.reader = std::unique_ptr<juce::AudioFormatReader> (formatManager.createReaderFor (slot.loadedSample->file));
+            slot.writeEnd = slot.loadedSample->residentFrames;
+            publish (slot, generation, slot.writeEnd);
+        }
+
+        return true;
+    }
+
+    const auto* sample = slot.loadedSample;
+    if (sample == nullptr || slot.reader == nullptr)
+        return false;
+
+    // Včetně nulového guard frame za koncem vzorku (reader za koncem vrací ticho)
+    const auto endFrame = (juce::int64) sample->numFrames + 1;
+    const auto playhead = slot.playhead.load (std::memory_order_acquire);
+
+    // Po podtečení playhead předběhl data - doplňuje se od playheadu včetně historie
+    // interpolace (playhead už je o ni posunutý), ring se tedy nepřepíše za oknem hlasu
+    if (playhead > slot.writeEnd)
+        slot.writeEnd = playhead;
+
+    // Framy [playhead, playhead + ringFrames) se do ringu vejdou bez přepsání okna hlasu
+    const auto target = juce::jmin (endFrame, playhead + (juce::int64) ringFrames);
+    const auto toWrite = target - slot.writeEnd;
+
+    if (toWrite <= 0 || (toWrite < minReadChunkFrames && target < endFrame))
+        return false;
+
+    const int chunk = (int) juce::jmin (toWrite, (juce::int64) maxReadChunkFrames);
+
+    for (int done = 0; done < chunk;)
+    {
+        const auto frame = slot.writeEnd + done;
+        const int ringPosition = (int) (frame & ringMask);
+        const int numToRead = juce::jmin (chunk - done, ringFrames - ringPosition);
+
+        slot.reader->read (&slot.ring, ringPosition, numToRead, frame, true, true);
+        done += numToRead;
+    }
+
+    // Audio vlákno mezitím slot restartovalo - data se nepublikují
+    if (slot.generation.load (std::memory_order_acquire) != generation)
+        return true;
+
+    slot.writeEnd += chunk;
+    publish (slot, generation, slot.writeEnd);
+    return true;
+}
+
+//==============================================================================
+SampleStreamer::IoThread::IoThread (SampleStreamer& o, int threadIndex)
+    : juce::Thread ("IthacaPlayer DFD I/O " + juce::String (threadIndex)),
+      owner (o),
+      index (threadIndex)
+{
+    formatManager.registerBasicFormats();
+}
+
+void SampleStreamer::IoThread::run()
+{
+    while (! threadShouldExit())
+    {
+        bool didWork = false;
+
+        for (size_t i = (size_t) index; i < owner.slots.size(); i += (size_t) owner.numIoThreads)
+            didWork = owner.serviceSlot (*owner.slots[i], formatManager) || didWork;
+
+        completedPasses.fetch_add (1, std::memory_order_release);
+
+        if (! didWork)
+            wait (2);
+    }
+}
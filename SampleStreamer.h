@@ -0,0 +1,122 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "SampleLibrary.h"
+
+/**
+ * Třída SampleStreamer - direct-from-disk (DFD) přehrávání vzorků.
+ *
+ * Každý hlas má vlastní slot s ring bufferem. Vzorek v paměti drží jen
+ * rezidentní začátek (SampleData::residentFrames); zbytek doplňují I/O vlákna
+ * na pozadí s předstihem před playheadem. Audio vlákno soubory nikdy neotevírá:
+ * při note-on jen zapíše do slotu nový vzorek a zvýší generaci, I/O vlákno
+ * si změny všimne, otevře reader a začne plnit ring.
+ *
+ * Synchronizace (bez zámků):
+ *  - generation/sample/playhead zapisuje pouze audio vlákno,
+ *  - published = (generace << 48) | konec platných dat, zapisuje pouze I/O vlákno,
+ *  - každý slot obsluhuje vždy stejné I/O vlákno (slot % počet vláken).
+ * Data z jiné generace audio vlákno ignoruje, takže restart slotu nevyžaduje čekání.
+ */
+class SampleStreamer
+{
+public:
+    SampleStreamer() = default;
+    ~SampleStreamer();
+
+    // Alokace slotů a spuštění I/O vláken (volat mimo audio vlákno)
+    void prepare (int numSlots, int ringFrames, int numThreads);
+
+    // Zastavení I/O vláken a uvolnění slotů (volat mimo audio vlákno)
+    void release();
+
+    // Zastavení všech streamů a počkání, až I/O vlákna pustí readery (mimo audio vlákno)
+    void stopAllAndWait();
+
+    /**
+     * Počkání, až každé I/O vlákno dokončí celý průchod svými sloty začatý
+     * po zavolání (mimo audio vlákno). Potom žádné vlákno nedrží vzorek,
+     * jehož streamy audio vlákno před voláním zastavilo. false = timeout.
+     */
+    bool waitForServicePass (int timeoutMs);
+
+    bool isPrepared() const noexcept { return ! slots.empty(); }
+
+    //==============================================================================
+    // Audio vlákno
+
+    // Start streamu pro vzorek; vrací generaci, kterou si hlas uloží
+    juce::uint32 startStream (int slot, const SampleData* sample) noexcept;
+    void stopStream (int slot) noexcept;
+
+    // Nejstarší frame, který hlas ještě přečte (pozice minus historie interpolace);
+    // I/O vlákno před něj nezapisuje a po podtečení od něj doplňuje
+    void setPlayhead (int slot, juce::int64 frame) noexcept;
+
+    // Konec souvislých platných dat v ringu (exkluzivně); pro cizí generaci residentFrames
+    juce::int64 getAvailableEnd (int slot, juce::uint32 generation, juce::int64 residentFrames) const noexcept;
+
+    const float* getRingChannel (int slot, int channel) const noexcept;
+    int getRingMask() const noexcept { return ringMask; }
+
+    void reportUnderrun() noexcept { underruns.fetch_add (1, std::memory_order_relaxed); }
+
+    //==============================================================================
+    // Počet podtečení ringu (hlas chtěl data, která I/O vlákno ještě nenačetlo)
+    juce::uint64 getUnderrunCount() const noexcept { return underruns.load (std::memory_order_relaxed); }
+
+private:
+    static constexpr int minReadChunkFrames = 2048;
+    static constexpr int maxReadChunkFrames = 16384;
+
+    struct Slot
+    {
+        juce::AudioBuffer<float> ring;
+
+        // Zapisuje audio vlákno
+        std::atomic<const SampleData*> sample { nullptr };
+        std::atomic<juce::uint32> generation { 0 };
+        std::atomic<juce::int64> playhead { 0 };
+
+        // Zapisuje I/O vlákno
+        std::atomic<juce::uint64> published { 0 };
+
+        // Stav vlastněný I/O vláknem
+        juce::uint32 loadedGeneration = 0;
+        const SampleData* loadedSample = nullptr;
+        std::unique_ptr<juce::AudioFormatReader> reader;
+        juce::int64 writeEnd = 0;
+    };
+
+    class IoThread : public juce::Thread
+    {
+    public:
+        IoThread (SampleStreamer& o, int threadIndex);
+        void run() override;
+
+        std::atomic<juce::uint64> completedPasses { 0 };
+
+    private:
+        SampleStreamer& owner;
+        const int index;
+        juce::AudioFormatManager formatManager;
+    };
+
+    bool serviceSlot (Slot& slot, juce::AudioFormatManager& formatManager);
+    static void publish (Slot& slot, juce::uint32 generation, juce::int64 end) noexcept;
+    void startThreads();
+    void stopThreads();
+
+    std::vector<std::unique_ptr<Slot>> slots;
+    std::vector<std::unique_ptr<IoThread>> threads;
+    int numIoThreads = 0;
+    int ringFrames = 0;
+    int ringMask = 0;
+
+    std::atomic<juce::uint64> underruns { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE (SampleStreamer)
+};
@@ -0,0 +1,1075 @@
+#include "SamplerEngine.h"
+
+void SamplerEngine::prepare (double sampleRate, int maxBlockSize, const SamplerSettings& settings)
+{
+    juce::ignoreUnused (maxBlockSize);
+
+    currentSampleRate = sampleRate > 0.0 ? sampleRate : 44100.0;
+
+    // Fyzických hlasů je víc než polyfonie - rezerva pro doznívání ukradených hlasů
+    const int numVoices = allocator.prepare (settings.maxVoices);
+    allocator.setStealPolicy (settings.stealPolicy);
+
+    voices.assign ((size_t) numVoices, Voice());
+    mix.resize (numVoices);
+    for (int i = 0; i < numVoices; ++i)
+        voices[(size_t) i].streamSlot = i;
+
+    envelopes.prepare (numVoices, currentSampleRate, IthacaConfig::STEAL_FADE_SECONDS);
+    setEnvelope (settings.attackSeconds, settings.decaySeconds, settings.sustainLevel, settings.releaseSeconds);
+    applyPendingEnvelope();
+
+    // Slot s ring bufferem pro každý hlas; bez DFD se I/O vlákna nespouští
+    if (settings.streamFromDisk)
+        streamer.prepare (numVoices, settings.streamBufferFrames, settings.numStreamingThreads);
+    else
+        streamer.release();
+
+    // Dekodéry bloků komprimovaných vzorků (jinak se nealokují)
+    if (settings.sampleStorage == SampleStorage::Compressed)
+    {
+        decodedBlocks.assign ((size_t) numVoices * 4 * SampleCodec::blockFrames, 0);
+        blockDecoders.assign ((size_t) numVoices * 2, SampleCodec::Decoder());
+    }
+    else
+    {
+        decodedBlocks.clear();
+        decodedBlocks.shrink_to_fit();
+        blockDecoders.clear();
+        blockDecoders.shrink_to_fit();
+    }
+
+    interpolationQuality = settings.interpolationQuality;
+    velocityCrossfade = settings.velocityCrossfade;
+    variantSelection = settings.variantSelection;
+    variantCursors.fill (0);
+    noteCounter = 0;
+    drainingLibrary = nullptr;
+}
+
+void SamplerEngine::setEnvelope (float attackSeconds, float decaySeconds, float sustainLevel, float releaseSeconds) noexcept
+{
+    envelopeAttack = attackSeconds;
+    envelopeDecay = decaySeconds;
+    envelopeSustain = sustainLevel;
+    envelopeRelease = releaseSeconds;
+    envelopeChanged.store (true, std::memory_order_release);
+}
+
+// Převzetí parametrů obálky (audio vlákno; při souběžném zápisu se převezmou v dalším bloku)
+void SamplerEngine::applyPendingEnvelope() noexcept
+{
+    if (envelopeChanged.exchange (false, std::memory_order_acquire))
+        envelopes.setParameters (envelopeAttack.load(), envelopeDecay.load(), envelopeSustain.load(), envelopeRelease.load());
+}
+
+void SamplerEngine::setLibrary (const SampleLibrary* newLibrary)
+{
+    // Hlasy ani I/O vlákna nesmí ukazovat do starého nástroje
+    reset();
+
+    if (streamer.isPrepared())
+        streamer.stopAllAndWait();
+
+    library = newLibrary;
+    pendingLibrary = nullptr;
+    drainingLibrary = nullptr;
+    activeLibrary = newLibrary;
+}
+
+void SamplerEngine::requestLibrary (const SampleLibrary* newLibrary) noexcept
+{
+    pendingLibrary.store (newLibrary, std::memory_order_release);
+}
+
+bool SamplerEngine::isLibraryInUse (const SampleLibrary* candidate) const noexcept
+{
+    // Seqlock: během převzetí drží audio vlákno nástroj jen v lokální proměnné
+    const auto sequence = swapSequence.load();
+    if ((sequence & 1) != 0)
+        return true;
+
+    const bool inUse = pendingLibrary.load() == candidate
+                    || activeLibrary.load() == candidate
+                    || drainingLibrary.load() == candidate;
+
+    return inUse || swapSequence.load() != sequence;
+}
+
+bool SamplerEngine::waitUntilLibraryUnused (const SampleLibrary* candidate, int timeoutMs)
+{
+    const auto deadline = juce::Time::getMillisecondCounter() + (juce::uint32) juce::jmax (0, timeoutMs);
+
+    while (isLibraryInUse (candidate))
+    {
+        if (juce::Time::getMillisecondCounter() >= deadline)
+            return false;
+
+        juce::Thread::sleep (2);
+    }
+
+    // Zastavené streamy mohou I/O vlákna ještě chvíli obsluhovat
+    if (! streamer.isPrepared())
+        return true;
+
+    return streamer.waitForServicePass ((int) juce::jmax ((juce::int64) 1, (juce::int64) deadline - (juce::int64) juce::Time::getMillisecondCounter()));
+}
+
+/**
+ * Převzetí nástroje z requestLibrary() (audio vlákno, začátek bloku).
+ * Hlasy dosavadního nástroje přejdou do release; až všechny doznějí,
+ * uvolní se drainingLibrary a vlastník může starý nástroj smazat.
+ */
+void SamplerEngine::applyPendingLibrary() noexcept
+{
+    if (pendingLibrary.load (std::memory_order_relaxed) == nullptr
+        && drainingLibrary.load (std::memory_order_relaxed) == nullptr)
+        return;
+
+    swapSequence.fetch_add (1);
+
+    if (const auto* next = pendingLibrary.exchange (nullptr))
+    {
+        // Předchozí výměna ještě doznívá - její hlasy se utnou (odzadu, stopVoice mění seznam)
+        if (drainingLibrary.load() != nullptr)
+        {
+            for (int i = allocator.getNumActive(); --i >= 0;)
+            {
+                auto& voice = voices[(size_t) allocator.getActiveVoices()[i]];
+                if (voice.startOrder <= drainStartOrder)
+                    stopVoice (voice);
+            }
+        }
+
+        drainingLibrary = library;
+        drainStartOrder = noteCounter;
+        allNotesOff();
+
+        library = next;
+        activeLibrary = next;
+    }
+
+    if (drainingLibrary.load (std::memory_order_relaxed) != nullptr)
+    {
+        bool draining = false;
+        for (int i = 0; i < allocator.getNumActive(); ++i)
+            draining = draining || voices[(size_t) allocator.getActiveVoices()[i]].startOrder <= drainStartOrder;
+
+        if (! draining)
+            drainingLibrary = nullptr;
+    }
+
+    swapSequence.fetch_add (1);
+}
+
+void SamplerEngine::stopVoice (Voice& voice) noexcept
+{
+    if (voice.streaming)
+        streamer.stopStream (voice.streamSlot);
+
+    voice.active = false;
+    voice.streaming = false;
+    allocator.release (voice.streamSlot);
+}
+
+void SamplerEngine::reset() noexcept
+{
+    for (auto& voice : voices)
+    {
+        if (voice.streaming)
+            streamer.stopStream (voice.streamSlot);
+
+        const int slot = voice.streamSlot;
+        voice = Voice();
+        voice.streamSlot = slot;
+    }
+
+    allocator.reset();
+    envelopes.stopAll();
+    channels.fill (ChannelState());
+}
+
+/**
+ * Render bloku: segmenty mezi MIDI událostmi se renderují zvlášť,
+ * takže nota i změna controlleru platí od samplePosition své události
+ * (s přesností minimální délky segmentu).
+ */
+void SamplerEngine::renderBlock (juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& midiMessages) noexcept
+{
+    applyPendingLibrary();
+    applyPendingEnvelope();
+
+    MidiScheduler::process (midiMessages, buffer.getNumSamples(), minSegmentSamples,
+        [this, &buffer] (int startSample, int numSamples) noexcept { renderVoices (buffer, startSample, numSamples); },
+        [this] (const juce::uint8* data, int numBytes, int) noexcept { handleMidiEvent (data, numBytes); });
+}
+
+void SamplerEngine::handleMidiEvent (const juce::uint8* data, int numBytes) noexcept
+{
+    if (numBytes < 1)
+        return;
+
+    const int status = data[0] & 0xf0;
+    const int channel = (data[0] & 0x0f) + 1;
+    const int data1 = numBytes > 1 ? data[1] : 0;
+    const int data2 = numBytes > 2 ? data[2] : 0;
+
+    if (status == 0x90 && data2 > 0)
+        noteOn (channel, data1, data2);
+    else if (status == 0x80 || status == 0x90)
+        noteOff (channel, data1);
+    else if (status == 0xb0)
+        controllerChange (channel, data1, data2);
+    else if (status == 0xe0)
+        pitchBend (channel, data1 | (data2 << 7));
+}
+
+void SamplerEngine::controllerChange (int channel, int controller, int value) noexcept
+{
+    auto& state = getChannel (channel);
+
+    switch (controller)
+    {
+        case 7:
+            state.volume = (float) value / 127.0f;
+            updateChannelGain (channel);
+            break;
+
+        case 10:
+            state.pan = (float) value / 127.0f;
+            updateChannelGain (channel);
+            break;
+
+        case 11:
+            state.expression = (float) value / 127.0f;
+            updateChannelGain (channel);
+            break;
+
+        case 64:
+            setSustainPedal (channel, (float) value / 127.0f);
+            break;
+
+        case 66:
+            setSostenutoPedal (channel, value >= 64);
+            break;
+
+        case 67:
+            state.softPedal = (float) value / 127.0f;
+            break;
+
+        case 120:   // All Sound Off
+        case 123:   // All Notes Off
+            allNotesOff();
+            break;
+
+        case 121:   // Reset All Controllers
+            resetControllers (channel);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * Pitch bend kanálu - přepočet kroku všech jeho znějících hlasů.
+ */
+void SamplerEngine::pitchBend (int channel, int value14bit) noexcept
+{
+    auto& state = getChannel (channel);
+    const double semitones = (double) (value14bit - 8192) / 8192.0 * IthacaConfig::PITCH_BEND_RANGE_SEMITONES;
+    state.pitchBendRatio = std::pow (2.0, semitones / 12.0);
+
+    for (int i = 0; i < allocator.getNumActive(); ++i)
+    {
+        auto& voice = voices[(size_t) allocator.getActiveVoices()[i]];
+        if (voice.channel == channel)
+            mix.increments[(size_t) allocator.getActiveVoices()[i]] = voice.baseIncrement * state.pitchBendRatio;
+    }
+}
+
+/**
+ * Gain L/R kanálu (volume * expression * pan) a jeho přepočet do mixu všech
+ * znějících hlasů kanálu. Stereo vzorky: balance (střed = 1 na obou stranách);
+ * mono vzorky: constant-power pan (střed = 1, krajní poloha +3 dB na jedné straně).
+ */
+void SamplerEngine::updateChannelGain (int channel) noexcept
+{
+    auto& state = getChannel (channel);
+    const float gain = state.volume * state.expression;
+    state.gainL = gain * juce::jmin (1.0f, 2.0f * (1.0f - state.pan));
+    state.gainR = gain * juce::jmin (1.0f, 2.0f * state.pan);
+
+    MixKernels::getConstantPowerGains (state.pan, state.monoGainL, state.monoGainR);
+    state.monoGainL *= gain;
+    state.monoGainR *= gain;
+
+    for (int i = 0; i < allocator.getNumActive(); ++i)
+    {
+        const int voiceIndex = allocator.getActiveVoices()[i];
+        if (voices[(size_t) voiceIndex].channel == channel)
+            setVoiceGain (voiceIndex, voices[(size_t) voiceIndex].gain);
+    }
+}
+
+void SamplerEngine::setVoiceGain (int voiceIndex, float gain) noexcept
+{
+    auto& voice = voices[(size_t) voiceIndex];
+    const auto& state = getChannel (voice.channel);
+
+    const bool monoSample = mix.samples[(size_t) voiceIndex]->getNumChannels() == 1;
+
+    voice.gain = gain;
+    mix.gainsL[(size_t) voiceIndex] = gain * (monoSample ? state.monoGainL : state.gainL);
+    mix.gainsR[(size_t) voiceIndex] = gain * (monoSample ? state.monoGainR : state.gainR);
+}
+
+/**
+ * Sustain pedál se spojitou hloubkou. Prochází se jen noty z sustainedNotes
+ * (note-off přišel při pedálu), hlas se najde přes tabulku držených not.
+ * Half-pedal: tlumítka se dotýkají strun, noty držené sustainem doznívají
+ * zpomaleným release (krok * (1 - hloubka)^3, nejvýš HALF_PEDAL_MIN_RELEASE_SPEED);
+ * pod prahem se uvolní.
+ * Noty zachycené sostenutem se nemění.
+ */
+void SamplerEngine::setSustainPedal (int channel, float level) noexcept
+{
+    auto& state = getChannel (channel);
+    if (state.sustainLevel == level)
+        return;
+
+    const float depth = juce::jlimit (0.0f, 1.0f, (level - IthacaConfig::SUSTAIN_PEDAL_OFF_LEVEL)
+                                                  / (IthacaConfig::SUSTAIN_PEDAL_FULL_LEVEL - IthacaConfig::SUSTAIN_PEDAL_OFF_LEVEL));
+    state.sustainLevel = level;
+    state.sustainDamping = depth >= 1.0f ? 0.0f
+                                         : juce::jmax (IthacaConfig::HALF_PEDAL_MIN_RELEASE_SPEED, (1.0f - depth) * (1.0f - depth) * (1.0f - depth));
+
+    state.sustainedNotes.forEach ([this, channel, &state] (int note) noexcept
+    {
+        if (state.sostenutoNotes.test (note))
+            return;
+
+        const int voiceIndex = allocator.findHeldVoice (channel, note);
+        if (voiceIndex >= 0 && state.holdsSustain())
+        {
+            setDamping (voiceIndex, state.sustainDamping);
+            return;
+        }
+
+        state.sustainedNotes.reset (note);
+        if (voiceIndex >= 0)
+            releaseStrikes (voiceIndex);
+    });
+}
+
+/**
+ * Sostenuto zachytí klávesy stisknuté v okamžiku sešlápnutí; drží jen je.
+ * Po uvolnění se zachycené noty s puštěnou klávesou předají sustainu, nebo uvolní.
+ */
+void SamplerEngine::setSostenutoPedal (int channel, bool down) noexcept
+{
+    auto& state = getChannel (channel);
+    if (state.sostenutoPedal == down)
+        return;
+
+    state.sostenutoPedal = down;
+    if (down)
+    {
+        state.sostenutoNotes = state.keysDown;
+        return;
+    }
+
+    const auto latched = state.sostenutoNotes;
+    state.sostenutoNotes.clear();
+
+    latched.forEach ([this, channel, &state] (int note) noexcept
+    {
+        if (! state.sustainedNotes.test (note))
+            return;
+
+        const int voiceIndex = allocator.findHeldVoice (channel, note);
+        if (voiceIndex >= 0 && state.holdsSustain())
+        {
+            setDamping (voiceIndex, state.sustainDamping);
+            return;
+        }
+
+        state.sustainedNotes.reset (note);
+        if (voiceIndex >= 0)
+            releaseStrikes (voiceIndex);
+    });
+}
+
+void SamplerEngine::resetControllers (int channel) noexcept
+{
+    setSustainPedal (channel, 0.0f);
+    setSostenutoPedal (channel, false);
+    getChannel (channel).softPedal = 0.0f;
+    pitchBend (channel, 8192);
+
+    auto& state = getChannel (channel);
+    state.volume = 100.0f / 127.0f;
+    state.expression = 1.0f;
+    state.pan = 0.5f;
+    updateChannelGain (channel);
+}
+
+void SamplerEngine::noteOn (int channel, int midiNote, int velocity) noexcept
+{
+    auto& state = getChannel (channel);
+    state.keysDown.set (midiNote);
+
+    if (library == nullptr || voices.empty())
+        return;
+
+    // Soft pedál (una corda) ztlumí úder - slabší velocity vybere i tišší vrstvu
+    if (state.softPedal > 0.0f)
+        velocity = juce::jmax (1, juce::roundToInt ((float) velocity
+                                                    * (1.0f - (1.0f - IthacaConfig::SOFT_PEDAL_VELOCITY_SCALE) * state.softPedal)));
+
+    // Vrstva, kompenzace hlasitosti i váhy crossfade jsou předpočítané v tabulce nástroje
+    const auto& mapping = library->getVelocityMapping (midiNote, velocity);
+    if (mapping.group < 0)
+        return;
+
+    // Obě vrstvy crossfade hrají stejnou variantu (index se bere modulo počet variant skupiny)
+    const auto variant = chooseVariant (midiNote, library->getNumVariants (mapping.group));
+    const auto& sample = library->getVariantSample (mapping.group, variant);
+    if (sample.numFrames <= 0)
+        return;
+
+    // Opakovaný úder držené noty - předchozí hlas přejde do release (restart same note),
+    // pokud ho nedrží pedál; pak zní dál a nový úder se na něj zřetězí
+    const int heldVoice = allocator.findHeldVoice (channel, midiNote);
+    const bool keepRinging = heldVoice >= 0 && state.isHeldByPedal (midiNote);
+    const auto heldOrder = heldVoice >= 0 ? voices[(size_t) heldVoice].startOrder : 0;
+
+    if (heldVoice >= 0 && ! keepRinging)
+        releaseStrikes (heldVoice);
+
+    state.sustainedNotes.reset (midiNote);
+
+    const bool crossfade = velocityCrossfade.load (std::memory_order_relaxed)
+                        && mapping.crossfadeGroup >= 0
+                        && library->getVariantSample (mapping.crossfadeGroup, variant).numFrames > 0;
+
+    const int voiceIndex = startVoice (channel, midiNote, sample, mapping.pitchRatio,
+                                       crossfade ? mapping.weight : mapping.gain, true);
+    if (voiceIndex < 0)
+        return;
+
+    if (keepRinging)
+    {
+        auto& voice = voices[(size_t) voiceIndex];
+        voice.previousStrike = heldVoice;
+        voice.previousStrikeOrder = heldOrder;
+
+        // Předchozí úder mohl při alokaci doznít po steal nebo být utnut - pak se nezřetězí
+        if (getPreviousStrike (voice) < 0 || allocator.isFading (heldVoice))
+        {
+            voice.previousStrike = -1;
+        }
+        else
+        {
+            // Klávesa je znovu dole - dřívější údery tlumítko netlumí
+            setDamping (heldVoice, 0.0f);
+            limitStrikes (voiceIndex);
+        }
+    }
+
+    if (! crossfade)
+        return;
+
+    // Druhá vrstva jen z volných hlasů - kvůli crossfade se nekrade; jinak hraje vrstva sama s kompenzací
+    const int companionIndex = allocator.hasFreeVoice()
+                                 ? startVoice (channel, midiNote, library->getVariantSample (mapping.crossfadeGroup, variant),
+                                               mapping.pitchRatio, mapping.crossfadeWeight, false)
+                                 : -1;
+
+    auto& voice = voices[(size_t) voiceIndex];
+
+    if (companionIndex >= 0)
+    {
+        voice.companion = companionIndex;
+        voice.companionOrder = voices[(size_t) companionIndex].startOrder;
+    }
+    else
+    {
+        setVoiceGain (voiceIndex, mapping.gain);
+    }
+}
+
+/**
+ * Varianta pro další úder noty - O(1), bez alokací (audio vlákno).
+ * Round-robin vrací rostoucí kurzor noty (modulo dělá SampleLibrary),
+ * náhodný výběr xorshift32 a kurzor si pamatuje poslední variantu.
+ */
+juce::uint32 SamplerEngine::chooseVariant (int midiNote, int numVariants) noexcept
+{
+    if (numVariants <= 1)
+        return 0;
+
+    auto& cursor = variantCursors[(size_t) (midiNote & 0x7f)];
+
+    if (variantSelection.load (std::memory_order_relaxed) == VariantSelection::RoundRobin)
+        return cursor++;
+
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+
+    const auto count = (juce::uint32) numVariants;
+    auto choice = randomState % count;
+    if (choice == cursor % count)
+        choice = (choice + 1) % count;
+
+    cursor = choice;
+    return choice;
+}
+
+/**
+ * Přidělení a spuštění hlasu se vzorkem. Vrací index hlasu, -1 = žádný hlas.
+ */
+int SamplerEngine::startVoice (int channel, int midiNote, const SampleData& sample, float pitchRatio, float gain,
+                               bool holdsNote) noexcept
+{
+    int stolenVoice = -1, killedVoice = -1;
+    const int voiceIndex = allocator.allocate (channel, midiNote, [this] (int index) noexcept
+    {
+        return voices[(size_t) index].gain * envelopes.getLevel (index);
+    }, stolenVoice, killedVoice, holdsNote);
+
+    if (voiceIndex < 0)
+        return -1;
+
+    // Ukradený hlas (i s druhou vrstvou crossfade) dozní krátkým fade-outem ve svém slotu
+    if (stolenVoice >= 0)
+    {
+        fadeOutVoice (stolenVoice);
+
+        const int companion = getCompanion (voices[(size_t) stolenVoice]);
+        if (companion >= 0)
+            fadeOutVoice (companion);
+
+        // Starší údery noty už nejsou v tabulce držených not - uvolní se hned
+        const int previous = getPreviousStrike (voices[(size_t) stolenVoice]);
+        if (previous >= 0)
+            releaseStrikes (previous);
+    }
+
+    auto& voice = voices[(size_t) voiceIndex];
+
+    // Utnutý hlas (plná rezerva) - jeho stream se zastaví, slot převezme nová nota
+    if (killedVoice >= 0 && voice.streaming)
+        streamer.stopStream (voice.streamSlot);
+
+    voice.baseIncrement = (double) pitchRatio * sample.sampleRate / currentSampleRate;
+    voice.midiNote = midiNote;
+    voice.channel = channel;
+    voice.startOrder = ++noteCounter;
+    voice.companion = -1;
+    voice.previousStrike = -1;
+    voice.active = true;
+    envelopes.start (voiceIndex);
+
+    const auto i = (size_t) voiceIndex;
+    mix.samples[i] = &sample;
+
+    if (2 * i < blockDecoders.size())
+    {
+        blockDecoders[2 * i].reset();
+        blockDecoders[2 * i + 1].reset();
+    }
+    mix.positions[i] = 0.0;
+    mix.increments[i] = voice.baseIncrement * getChannel (channel).pitchBendRatio;
+    setVoiceGain (voiceIndex, gain);
+
+    // Zbytek za rezidentní hlavičkou dočítají I/O vlákna (bez DFD hraje jen hlavička)
+    voice.streaming = sample.isStreamed() && streamer.isPrepared();
+    if (voice.streaming)
+        voice.streamGeneration = streamer.startStream (voice.streamSlot, &sample);
+
+    return voiceIndex;
+}
+
+void SamplerEngine::fadeOutVoice (int voiceIndex) noexcept
+{
+    envelopes.fadeOut (voiceIndex);
+}
+
+/**
+ * Druhá vrstva crossfade, pokud ještě hraje (slot mohl mezitím převzít jiný hlas).
+ */
+int SamplerEngine::getCompanion (const Voice& voice) const noexcept
+{
+    if (voice.companion < 0)
+        return -1;
+
+    const auto& companion = voices[(size_t) voice.companion];
+    return companion.active && companion.startOrder == voice.companionOrder ? voice.companion : -1;
+}
+
+/**
+ * Předchozí úder noty držený pedálem, pokud ještě hraje (slot mohl mezitím převzít jiný hlas).
+ */
+int SamplerEngine::getPreviousStrike (const Voice& voice) const noexcept
+{
+    if (voice.previousStrike < 0)
+        return -1;
+
+    const auto& previous = voices[(size_t) voice.previousStrike];
+    return previous.active && previous.startOrder == voice.previousStrikeOrder ? voice.previousStrike : -1;
+}
+
+// Release hlasu i všech jeho předchozích úderů
+void SamplerEngine::releaseStrikes (int voiceIndex) noexcept
+{
+    while (voiceIndex >= 0)
+    {
+        const int previous = getPreviousStrike (voices[(size_t) voiceIndex]);
+        releaseVoice (voiceIndex);
+        voiceIndex = previous;
+    }
+}
+
+/**
+ * Útlum not držených pedálem: release obálky s rychlostí damping (0 = zní
+ * volně). Platí pro celý řetěz úderů i druhé vrstvy crossfade; doznívající
+ * ukradené hlasy si nechávají svůj fade-out.
+ */
+void SamplerEngine::setDamping (int voiceIndex, float damping) noexcept
+{
+    for (; voiceIndex >= 0; voiceIndex = getPreviousStrike (voices[(size_t) voiceIndex]))
+    {
+        if (! allocator.isFading (voiceIndex))
+            envelopes.setReleaseSpeed (voiceIndex, damping);
+
+        const int companion = getCompanion (voices[(size_t) voiceIndex]);
+        if (companion >= 0 && ! allocator.isFading (companion))
+            envelopes.setReleaseSpeed (companion, damping);
+    }
+}
+
+// Nejvýš MAX_PEDAL_STRIKES_PER_NOTE úderů v řetězu; starší se uvolní
+void SamplerEngine::limitStrikes (int voiceIndex) noexcept
+{
+    int numStrikes = 1;
+
+    for (int current = voiceIndex, previous; (previous = getPreviousStrike (voices[(size_t) current])) >= 0; current = previous)
+    {
+        if (++numStrikes > IthacaConfig::MAX_PEDAL_STRIKES_PER_NOTE)
+        {
+            voices[(size_t) current].previousStrike = -1;
+            releaseStrikes (previous);
+            return;
+        }
+    }
+}
+
+void SamplerEngine::noteOff (int channel, int midiNote) noexcept
+{
+    auto& state = getChannel (channel);
+    state.keysDown.reset (midiNote);
+
+    // O(1) přes tabulku držených not
+    const int voiceIndex = allocator.findHeldVoice (channel, midiNote);
+    if (voiceIndex < 0)
+        return;
+
+    // Notu drží pedál - release přijde s jeho uvolněním (při half-pedal zpomaleně už teď)
+    if (state.isHeldByPedal (midiNote))
+    {
+        state.sustainedNotes.set (midiNote);
+        setDamping (voiceIndex, state.sostenutoNotes.test (midiNote) ? 0.0f : state.sustainDamping);
+    }
+    else
+    {
+        releaseStrikes (voiceIndex);
+    }
+}
+
+void SamplerEngine::allNotesOff() noexcept
+{
+    for (int i = 0; i < allocator.getNumActive(); ++i)
+        releaseVoice (allocator.getActiveVoices()[i]);
+
+    for (auto& state : channels)
+    {
+        state.sustainedNotes.clear();
+        state.sostenutoNotes.clear();
+    }
+}
+
+void SamplerEngine::releaseVoice (int voiceIndex) noexcept
+{
+    auto& voice = voices[(size_t) voiceIndex];
+    envelopes.release (voiceIndex);
+
+    allocator.noteReleased (voiceIndex);
+
+    // Druhá vrstva crossfade není v tabulce držených not - note-off dostává odsud
+    const int companion = getCompanion (voice);
+    if (companion >= 0)
+        releaseVoice (companion);
+}
+
+/**
+ * Render segmentu: obálky aktivních hlasů se posunou najednou (SoA,
+ * vektorizované), pak se vybere specializace mixu podle kvality interpolace.
+ */
+void SamplerEngine::renderVoices (juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    envelopes.process (allocator.getActiveVoices(), allocator.getNumActive(), numSamples);
+
+    switch (interpolationQuality.load (std::memory_order_relaxed))
+    {
+        case InterpolationQuality::Linear:  mixVoices<InterpolationQuality::Linear>  (buffer, startSample, numSamples); break;
+        case InterpolationQuality::Hermite: mixVoices<InterpolationQuality::Hermite> (buffer, startSample, numSamples); break;
+        case InterpolationQuality::Sinc8:   mixVoices<InterpolationQuality::Sinc8>   (buffer, startSample, numSamples); break;
+        case InterpolationQuality::Sinc16:  mixVoices<InterpolationQuality::Sinc16>  (buffer, startSample, numSamples); break;
+    }
+}
+
+/**
+ * Mix jen aktivních hlasů (nevirtuální smyčka přes seznam indexů); cena
+ * nezávisí na velikosti polyfonie. Prochází se odzadu, protože dohraný hlas
+ * se ze seznamu odebírá přesunem posledního.
+ */
+template <InterpolationQuality Quality>
+void SamplerEngine::mixVoices (juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    for (int i = allocator.getNumActive(); --i >= 0;)
+    {
+        const int voiceIndex = allocator.getActiveVoices()[i];
+        auto& voice = voices[(size_t) voiceIndex];
+        renderVoiceWith<Quality> (voiceIndex, buffer, startSample, numSamples);
+
+        // Hlas dohrál vzorek nebo release obálky doběhl pod práh ticha;
+        // stopVoice zastaví i stream, aby slot nedržel reader a vzorek starého nástroje
+        if (! voice.active || envelopes.isFinished (voiceIndex))
+            stopVoice (voice);
+    }
+}
+
+/**
+ * Společná smyčka renderu hlasu; readFrame vrací interpolovaný frame
+ * (false = data nejsou k dispozici, hraje se ticho). Hlas končí na numFrames.
+ * Interpoluje se po úsecích do scratch bufferu, gain s obálkou (lineární
+ * rampa) a přičtení do výstupu dělá vektorové jádro z MixKernels.
+ */
+template <typename FrameSource>
+void SamplerEngine::renderVoiceFrom (int voiceIndex, juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                                     int numFrames, FrameSource&& readFrame) noexcept
+{
+    const int numOutputChannels = buffer.getNumChannels();
+    if (numOutputChannels == 0)
+        return;
+
+    float* outL = buffer.getWritePointer (0, startSample);
+    float* outR = numOutputChannels > 1 ? buffer.getWritePointer (1, startSample) : nullptr;
+
+    // Obálka lineárně mezi hodnotami na začátku a konci segmentu
+    const auto v = (size_t) voiceIndex;
+    const bool monoSample = mix.samples[v]->getNumChannels() == 1;
+    double position = mix.positions[v];
+    const double increment = mix.increments[v];
+    const float envelopeStart = envelopes.getBlockStart (voiceIndex);
+    const float envelopeStep = (envelopes.getBlockEnd (voiceIndex) - envelopeStart) / (float) numSamples;
+
+    for (int chunkStart = 0; chunkStart < numSamples; chunkStart += mixChunkSamples)
+    {
+        const int chunkSize = juce::jmin (mixChunkSamples, numSamples - chunkStart);
+        int numRendered = 0;
+
+        for (; numRendered < chunkSize; ++numRendered)
+        {
+            const int index = (int) position;
+            if (index >= numFrames)
+            {
+                voices[v].active = false;
+                break;
+            }
+
+            float left = 0.0f, right = 0.0f;
+            if (! readFrame (index, (float) (position - (double) index), left, right))
+                left = right = 0.0f;
+
+            mixScratchL[(size_t) numRendered] = left;
+            mixScratchR[(size_t) numRendered] = right;
+            position += increment;
+        }
+
+        mixScratch (voiceIndex, monoSample, outL + chunkStart, outR != nullptr ? outR + chunkStart : nullptr,
+                    numRendered, envelopeStart + (float) chunkStart * envelopeStep, envelopeStep);
+
+        if (numRendered < chunkSize)
+            break;
+    }
+
+    mix.positions[v] = position;
+}
+
+/**
+ * Přičtení scratch bufferu do výstupu s gainem hlasu a rampou obálky.
+ * Mono vzorek se do sterea rozkládá jedním průchodem (mixAddPanned),
+ * mono výstup dostává průměr stran.
+ */
+void SamplerEngine::mixScratch (int voiceIndex, bool monoSample, float* outL, float* outR, int numSamples,
+                                float envelope, float envelopeStep) noexcept
+{
+    const float gainL = mix.gainsL[(size_t) voiceIndex];
+    const float gainR = mix.gainsR[(size_t) voiceIndex];
+
+    if (outR == nullptr)
+    {
+        kernels->mixAddRamp (outL, mixScratchL.data(), numSamples, 0.5f * gainL * envelope, 0.5f * gainL * envelopeStep);
+        kernels->mixAddRamp (outL, mixScratchR.data(), numSamples, 0.5f * gainR * envelope, 0.5f * gainR * envelopeStep);
+    }
+    else if (monoSample)
+    {
+        kernels->mixAddPanned (outL, outR, mixScratchL.data(), numSamples, envelope, envelopeStep, gainL, gainR);
+    }
+    else
+    {
+        kernels->mixAddRamp (outL, mixScratchL.data(), numSamples, gainL * envelope, gainL * envelopeStep);
+        kernels->mixAddRamp (outR, mixScratchR.data(), numSamples, gainR * envelope, gainR * envelopeStep);
+    }
+}
+
+/**
+ * Převod framů [first, first + numFrames) celočíselného vzorku do decodedL/R.
+ * Framy před začátkem a za guard framem jsou nuly; mono vzorek plní jen decodedL.
+ * Komprimovaný vzorek se skládá z postupně dekódovaných bloků hlasu (getDecodedFrames).
+ */
+void SamplerEngine::decodeFrames (int voiceIndex, const SampleData& sample, int first, int numFrames) noexcept
+{
+    const int end = first + numFrames;
+    const int validStart = juce::jlimit (first, end, 0);
+
+    if (sample.format == SampleFormat::Compressed)
+    {
+        // Guard frame není součástí kódovaných dat - za numFrames jsou nuly
+        const int validEnd = juce::jlimit (validStart, end, sample.numFrames);
+
+        for (int channel = 0; channel < sample.getNumChannels(); ++channel)
+        {
+            float* dest = channel == 0 ? decodedL.data() : decodedR.data();
+            std::fill (dest, dest + (validStart - first), 0.0f);
+            std::fill (dest + (validEnd - first), dest + numFrames, 0.0f);
+        }
+
+        for (int frame = validStart; frame < validEnd;)
+        {
+            const int block = frame / SampleCodec::blockFrames;
+            const int offset = frame - block * SampleCodec::blockFrames;
+            const int count = juce::jmin (validEnd - frame, SampleCodec::blockFrames - offset);
+            const int* decoded = getDecodedFrames (voiceIndex, sample, block, offset + count);
+
+            for (int channel = 0; channel < sample.getNumChannels(); ++channel)
+            {
+                float* dest = (channel == 0 ? decodedL.data() : decodedR.data()) + (frame - first);
+
+                if (decoded != nullptr)
+                {
+                    const int* in = decoded + channel * SampleCodec::blockFrames + offset;
+                    for (int i = 0; i < count; ++i)
+                        dest[i] = (float) in[i] * sample.scale;
+                }
+                else
+                {
+                    std::fill (dest, dest + count, 0.0f);
+                }
+            }
+
+            frame += count;
+        }
+
+        return;
+    }
+    const int validEnd = juce::jlimit (validStart, end, sample.residentFrames + 1);
+
+    for (int channel = 0; channel < sample.getNumChannels(); ++channel)
+    {
+        float* dest = channel == 0 ? decodedL.data() : decodedR.data();
+        std::fill (dest, dest + (validStart - first), 0.0f);
+
+        if (sample.format == SampleFormat::Int16)
+            kernels->int16ToFloat (dest + (validStart - first), sample.getChannel<juce::int16> (channel) + validStart,
+                                   validEnd - validStart, sample.scale);
+        else
+            kernels->int24ToFloat (dest + (validStart - first), sample.getChannel<juce::uint8> (channel) + 3 * (size_t) validStart,
+                                   validEnd - validStart, sample.scale);
+
+        std::fill (dest + (validEnd - first), dest + numFrames, 0.0f);
+    }
+}
+
+/**
+ * Framy [0, endFrame) bloku komprimovaného vzorku (int, kanály po blockFrames)
+ * z dekodéru hlasu. Dekóduje se jen chybějící část po oddílech, takže note-on
+ * ani přechod do dalšího bloku nedekódují celý blok najednou. Sudé a liché
+ * bloky mají vlastní slot - okno přes hranici bloků nezačíná blok znovu.
+ * nullptr = cache není připravená nebo je blok poškozený.
+ */
+const int* SamplerEngine::getDecodedFrames (int voiceIndex, const SampleData& sample, int block, int endFrame) noexcept
+{
+    const auto slot = 2 * (size_t) voiceIndex + (size_t) (block & 1);
+    if (slot >= blockDecoders.size())
+        return nullptr;
+
+    auto& decoder = blockDecoders[slot];
+    int* dest = decodedBlocks.data() + slot * 2 * SampleCodec::blockFrames;
+
+    if (decoder.getBlock() != block)
+    {
+        int* const blockChannels[2] = { dest, dest + SampleCodec::blockFrames };
+        if (! decoder.start (sample.channelData[0], block, blockChannels))
+            return nullptr;
+    }
+
+    return decoder.decodeUntil (endFrame) ? dest : nullptr;
+}
+
+/**
+ * Render hlasu s danou kvalitou interpolace. Jádro dostává souvislé okno
+ * vzorků; uvnitř rezidentních dat (guard frame na konci) nebo ringu se
+ * předá přímo ukazatel, na okrajích se okno složí po framech (mimo vzorek nuly).
+ * Streamovaný vzorek přechází za hlavičkou do ringu slotu; chybějící data
+ * v ringu se počítají jako podtečení.
+ */
+template <InterpolationQuality Quality>
+void SamplerEngine::renderVoiceWith (int voiceIndex, juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    using Kernel = Interpolator::Kernel<Quality>;
+    constexpr int numTaps = Kernel::numTaps;
+    constexpr int tapOffset = Kernel::tapOffset;
+
+    const auto& voice = voices[(size_t) voiceIndex];
+    const auto& sample = *mix.samples[(size_t) voiceIndex];
+    const int headEnd = sample.residentFrames;     // Poslední platný index hlavičky (guard)
+    float windowL[numTaps], windowR[numTaps];
+
+    if (sample.format != SampleFormat::Float32)
+    {
+        // Nativní int16 / packed int24 / komprimované (jen plně rezidentní vzorky): úsek framů
+        // se převede na float (decodeFrames) a interpolace čte z převedeného okna
+        const int windowFrames = juce::jlimit (numTaps + 1, decodeWindowFrames,
+                                               (int) (numSamples * mix.increments[(size_t) voiceIndex]) + numTaps + 2);
+        const bool monoSample = sample.getNumChannels() == 1;
+        int windowStart = 0, windowEnd = 0;
+
+        renderVoiceFrom (voiceIndex, buffer, startSample, numSamples, sample.residentFrames, [&] (int index, float frac, float& left, float& right) noexcept
+        {
+            const int first = index - tapOffset;
+            if (first < windowStart || first + numTaps > windowEnd)
+            {
+                decodeFrames (voiceIndex, sample, first, windowFrames);
+                windowStart = first;
+                windowEnd = first + windowFrames;
+            }
+
+            left = Kernel::process (decodedL.data() + (first - windowStart), frac);
+            right = monoSample ? left : Kernel::process (decodedR.data() + (first - windowStart), frac);
+            return true;
+        });
+        return;
+    }
+
+    const float* headL = sample.getChannel<float> (0);
+    const float* headR = sample.getChannel<float> (1);
+
+    auto readHead = [&] (int index, float frac, float& left, float& right) noexcept
+    {
+        const int first = index - tapOffset;
+        if (first >= 0 && first + numTaps - 1 <= headEnd)
+        {
+            left = Kernel::process (headL + first, frac);
+            right = Kernel::process (headR + first, frac);
+            return true;
+        }
+
+        for (int j = 0; j < numTaps; ++j)
+        {
+            const int frame = first + j;
+            const bool inside = frame >= 0 && frame <= headEnd;
+            windowL[j] = inside ? headL[frame] : 0.0f;
+            windowR[j] = inside ? headR[frame] : 0.0f;
+        }
+
+        left = Kernel::process (windowL, frac);
+        right = Kernel::process (windowR, frac);
+        return true;
+    };
+
+    if (! voice.streaming)
+    {
+        // Bez běžícího streameru hraje streamovaný vzorek jen rezidentní hlavičku
+        renderVoiceFrom (voiceIndex, buffer, startSample, numSamples, sample.residentFrames, readHead);
+        return;
+    }
+
+    const int numFrames = sample.numFrames;
+    const auto availableEnd = streamer.getAvailableEnd (voice.streamSlot, voice.streamGeneration, headEnd);
+    const float* ringL = streamer.getRingChannel (voice.streamSlot, 0);
+    const float* ringR = streamer.getRingChannel (voice.streamSlot, sample.getNumChannels() > 1 ? 1 : 0);
+    const int mask = streamer.getRingMask();
+    bool underrun = false;
+
+    renderVoiceFrom (voiceIndex, buffer, startSample, numSamples, numFrames, [&] (int index, float frac, float& left, float& right) noexcept
+    {
+        const int first = index - tapOffset;
+        const int last = first + numTaps - 1;
+
+        if (last <= headEnd)
+            return readHead (index, frac, left, right);
+
+        // Okno zasahuje do ringu - všechna potřebná data musí být načtená
+        if ((juce::int64) juce::jmin (last, numFrames) >= availableEnd)
+        {
+            underrun = true;
+            return false;
+        }
+
+        if (first > headEnd && last <= numFrames && (first & mask) + numTaps <= mask + 1)
+        {
+            left = Kernel::process (ringL + (first & mask), frac);
+            right = Kernel::process (ringR + (first & mask), frac);
+            return true;
+        }
+
+        for (int j = 0; j < numTaps; ++j)
+        {
+            const int frame = first + j;
+
+            if (frame < 0 || frame > numFrames)
+            {
+                windowL[j] = windowR[j] = 0.0f;
+            }
+            else if (frame <= headEnd)
+            {
+                windowL[j] = headL[frame];
+                windowR[j] = headR[frame];
+            }
+            else
+            {
+                windowL[j] = ringL[frame & mask];
+                windowR[j] = ringR[frame & mask];
+            }
+        }
+
+        left = Kernel::process (windowL, frac);
+        right = Kernel::process (windowR, frac);
+        return true;
+    });
+
+    if (underrun)
+        streamer.reportUnderrun();
+
+    // Dohraný hlas zastaví stream v mixVoices (stopVoice). Playhead je nejstarší frame, který
+    // hlas ještě přečte - i po přepnutí na jádro s delší historií (Sinc16), aby ji ring nepřepsal
+    if (voice.active)
+        streamer.setPlayhead (voice.streamSlot, (juce::int64) mix.positions[(size_t) voiceIndex] - Interpolator::maxTapOffset);
+}
@@ -0,0 +1,279 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <atomic>
+#include <vector>
+#include "IthacaConfig.h"
+#include "Interpolator.h"
+#include "MidiScheduler.h"
+#include "MixKernels.h"
+#include "SampleCodec.h"
+#include "SampleLibrary.h"
+#include "SampleStreamer.h"
+#include "SamplerSettings.h"
+#include "VoiceAllocator.h"
+#include "VoiceEnvelopes.h"
+
+/**
+ * Třída SamplerEngine - polyfonní hlasový engine přehrávající vzorky z SampleLibrary.
+ *
+ * Všechny hlasy se alokují v prepare(); renderBlock() už nealokuje ani nezamyká.
+ * Přidělování, note-off a stealing řeší VoiceAllocator v O(1) / O(aktivní hlasy).
+ * MIDI události (noty, CC, pitch bend, pedály) se aplikují na svém
+ * samplePosition - blok se mezi událostmi rozdělí na segmenty (MidiScheduler)
+ * s nastavitelnou minimální délkou segmentu.
+ *
+ * Nový nástroj lze předat za běhu (requestLibrary); převezme se atomicky
+ * na začátku bloku, takže audio vlákno nikdy nečeká na načítání.
+ *
+ * Stav hlasu čtený při mixu (vzorek, playhead, krok, gain L/R) leží v polích
+ * MixState, obálky ve VoiceEnvelopes - obojí structure-of-arrays s indexem
+ * hlasu. Mix je nevirtuální smyčka přes seznam aktivních hlasů, specializovaná
+ * podle kvality interpolace jednou za segment; Voice drží jen stav pro události.
+ * ADSR obálka se počítá pro všechny aktivní hlasy najednou na začátku segmentu
+ * a hlas mezi hodnotami interpoluje. Hlas se interpoluje po úsecích
+ * (mixChunkSamples) do scratch bufferu a do výstupu přičte vektorovým
+ * jádrem MixKernels (gain s rampou obálky, mono vzorek s constant-power pan).
+ * Vzorky v nativním int16 / packed int24 se převádí na float až zde,
+ * po oknech framů před interpolací (decodeFrames). Komprimované vzorky
+ * (SampleCodec) dekóduje hlas postupně po oddílech, jen framy, které
+ * přehrává - cena na callback nezávisí na tom, kolik hlasů právě začíná blok.
+ *
+ * Pedály (sustain s half-pedal, sostenuto, soft) pracují s bitovými maskami
+ * not kanálu - změna pedálu prochází jen noty, kterých se týká, ne hlasy.
+ * Opakované údery noty držené pedálem znějí současně (řetěz přes
+ * previousStrike), nejvýš MAX_PEDAL_STRIKES_PER_NOTE; nejstarší se uvolní.
+ *
+ * Streamované vzorky (DFD) hraje hlas nejdřív z rezidentní hlavičky a pak
+ * z ringu svého slotu v SampleStreamer; souborový systém nikdy nevolá.
+ */
+class SamplerEngine
+{
+public:
+    SamplerEngine() = default;
+
+    // Příprava pro přehrávání (volat mimo audio vlákno, typicky z prepareToPlay)
+    void prepare (double sampleRate, int maxBlockSize, const SamplerSettings& settings);
+
+    // Nastavení nástroje (volat mimo audio vlákno, když renderBlock neběží)
+    void setLibrary (const SampleLibrary* newLibrary);
+
+    /**
+     * Výměna nástroje za běhu (volat mimo audio vlákno; volání serializovat).
+     * Audio vlákno hraje dosavadní nástroj, dokud nový na začátku bloku
+     * atomicky nepřevezme; hlasy starého nástroje pak doznějí release fází.
+     */
+    void requestLibrary (const SampleLibrary* newLibrary) noexcept;
+
+    // true, pokud nástroj čeká na převzetí, hraje, nebo ještě doznívají jeho hlasy
+    bool isLibraryInUse (const SampleLibrary* candidate) const noexcept;
+
+    /**
+     * Čekání, až nástroj nepoužívá audio vlákno ani I/O vlákna streameru
+     * (mimo audio vlákno). Potom ho lze uvolnit. false = timeout.
+     */
+    bool waitUntilLibraryUnused (const SampleLibrary* candidate, int timeoutMs);
+
+    // Okamžité umlčení všech hlasů
+    void reset() noexcept;
+
+    // Render bloku včetně zpracování MIDI (přičítá do bufferu)
+    void renderBlock (juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& midiMessages) noexcept;
+
+    void noteOn (int channel, int midiNote, int velocity) noexcept;
+    void noteOff (int channel, int midiNote) noexcept;
+    void allNotesOff() noexcept;
+    void controllerChange (int channel, int controller, int value) noexcept;
+    void pitchBend (int channel, int value14bit) noexcept;
+
+    // Nejkratší segment renderu mezi MIDI událostmi (1 = přesně na vzorek)
+    void setMinimumSegmentSize (int numSamples) noexcept { minSegmentSamples = juce::jmax (1, numSamples); }
+    int getMinimumSegmentSize() const noexcept { return minSegmentSamples; }
+
+    int getNumActiveVoices() const noexcept { return allocator.getNumActive(); }
+
+    // Kvalita interpolace lze měnit za běhu, projeví se od dalšího bloku
+    void setInterpolationQuality (InterpolationQuality quality) noexcept { interpolationQuality = quality; }
+    InterpolationQuality getInterpolationQuality() const noexcept { return interpolationQuality; }
+
+    // Crossfade sousedních velocity vrstev (druhá vrstva bere další hlas); za běhu
+    void setVelocityCrossfade (bool shouldCrossfade) noexcept { velocityCrossfade = shouldCrossfade; }
+    bool isVelocityCrossfadeEnabled() const noexcept { return velocityCrossfade; }
+
+    // Výběr varianty u round-robin skupin; za běhu
+    void setVariantSelection (VariantSelection selection) noexcept { variantSelection = selection; }
+    VariantSelection getVariantSelection() const noexcept { return variantSelection; }
+
+    /**
+     * ADSR obálka - lze měnit za běhu (mimo audio vlákno); audio vlákno ji
+     * převezme na začátku bloku a projeví se u dalších not a note-off.
+     */
+    void setEnvelope (float attackSeconds, float decaySeconds, float sustainLevel, float releaseSeconds) noexcept;
+
+    // Nejdelší doznívání po note-off - release zpomalený half-pedalem (setDamping) - pro getTailLengthSeconds()
+    double getTailLengthSeconds() const noexcept
+    {
+        return envelopeRelease.load (std::memory_order_relaxed) / IthacaConfig::HALF_PEDAL_MIN_RELEASE_SPEED;
+    }
+
+    // Počet podtečení DFD streamu (čte se mimo audio vlákno)
+    juce::uint64 getStreamUnderrunCount() const noexcept { return streamer.getUnderrunCount(); }
+
+private:
+    // Stav hlasu pro události (přidělení, note-off, pedály, stream)
+    struct Voice
+    {
+        double baseIncrement = 1.0;     // Krok bez pitch bendu (pitch * poměr sample rate)
+        float gain = 1.0f;              // Gain vrstvy (bez kanálu a obálky)
+        int midiNote = -1;
+        int channel = 0;
+        juce::uint64 startOrder = 0;    // Pořadí startu (odlišení hlasů vyměněného nástroje)
+        int companion = -1;             // Hlas druhé vrstvy crossfade (platí jen se shodným companionOrder)
+        juce::uint64 companionOrder = 0;
+        int previousStrike = -1;        // Předchozí úder noty držený pedálem (platí se shodným previousStrikeOrder)
+        juce::uint64 previousStrikeOrder = 0;
+        int streamSlot = 0;             // Index slotu v SampleStreamer (== index hlasu)
+        juce::uint32 streamGeneration = 0;
+        bool streaming = false;
+        bool active = false;
+    };
+
+    // Stav hlasů čtený při mixu - structure-of-arrays, index = index hlasu
+    struct MixState
+    {
+        std::vector<const SampleData*> samples;
+        std::vector<double> positions;          // Playhead ve vzorku (frames)
+        std::vector<double> increments;         // Krok na výstupní vzorek včetně pitch bendu kanálu
+        std::vector<float> gainsL, gainsR;      // Vrstva * kanál (volume, expression, pan)
+
+        void resize (int numVoices)
+        {
+            samples.assign ((size_t) numVoices, nullptr);
+            positions.assign ((size_t) numVoices, 0.0);
+            increments.assign ((size_t) numVoices, 1.0);
+            gainsL.assign ((size_t) numVoices, 0.0f);
+            gainsR.assign ((size_t) numVoices, 0.0f);
+        }
+    };
+
+    // Množina 128 MIDI not; forEach prochází jen nastavené bity
+    struct NoteMask
+    {
+        std::array<juce::uint64, 2> words {};
+
+        bool test (int note) const noexcept  { return (words[(size_t) ((note >> 6) & 1)] & bit (note)) != 0; }
+        void set (int note) noexcept         { words[(size_t) ((note >> 6) & 1)] |= bit (note); }
+        void reset (int note) noexcept       { words[(size_t) ((note >> 6) & 1)] &= ~bit (note); }
+        void clear() noexcept                { words = {}; }
+
+        // Funkce smí masku měnit - prochází se kopie
+        template <typename Function>
+        void forEach (Function&& function) const noexcept
+        {
+            const auto snapshot = words;
+            for (int w = 0; w < 2; ++w)
+                for (auto bits = snapshot[(size_t) w]; bits != 0; bits &= bits - 1)
+                    function (w * 64 + juce::countNumberOfBits ((bits & (~bits + 1)) - 1));
+        }
+
+    private:
+        static juce::uint64 bit (int note) noexcept { return (juce::uint64) 1 << (note & 63); }
+    };
+
+    // Stav MIDI kanálu (1-16) - mění se jen na audio vlákně
+    struct ChannelState
+    {
+        double pitchBendRatio = 1.0;
+        float volume = 100.0f / 127.0f;     // CC7
+        float expression = 1.0f;            // CC11
+        float pan = 0.5f;                   // CC10 (0 = vlevo, 1 = vpravo)
+        float gainL = 100.0f / 127.0f;      // volume * expression * balance (stereo vzorky)
+        float gainR = 100.0f / 127.0f;
+        float monoGainL = 100.0f / 127.0f;  // volume * expression * constant-power pan (mono vzorky)
+        float monoGainR = 100.0f / 127.0f;
+        float sustainLevel = 0.0f;          // CC64 jako 0-1 (half-pedal)
+        float sustainDamping = 1.0f;        // Násobek kroku release pro noty držené sustainem (0 = drží)
+        float softPedal = 0.0f;             // CC67 jako 0-1
+        bool sostenutoPedal = false;        // CC66
+        NoteMask keysDown;                  // Stisknuté klávesy (note-on bez note-off)
+        NoteMask sustainedNotes;            // Note-off přišel, notu drží pedál
+        NoteMask sostenutoNotes;            // Klávesy stisknuté v okamžiku sešlápnutí sostenuta
+
+        bool holdsSustain() const noexcept { return sustainLevel > IthacaConfig::SUSTAIN_PEDAL_OFF_LEVEL; }
+        bool isHeldByPedal (int note) const noexcept { return holdsSustain() || sostenutoNotes.test (note); }
+    };
+
+    void applyPendingLibrary() noexcept;
+    void stopVoice (Voice& voice) noexcept;
+    void releaseVoice (int voiceIndex) noexcept;
+    juce::uint32 chooseVariant (int midiNote, int numVariants) noexcept;
+    int startVoice (int channel, int midiNote, const SampleData& sample, float pitchRatio, float gain, bool holdsNote) noexcept;
+    void fadeOutVoice (int voiceIndex) noexcept;
+    void applyPendingEnvelope() noexcept;
+    int getCompanion (const Voice& voice) const noexcept;
+    void handleMidiEvent (const juce::uint8* data, int numBytes) noexcept;
+    void setSustainPedal (int channel, float level) noexcept;
+    void setSostenutoPedal (int channel, bool down) noexcept;
+    void releaseStrikes (int voiceIndex) noexcept;
+    void setDamping (int voiceIndex, float damping) noexcept;
+    void limitStrikes (int voiceIndex) noexcept;
+    int getPreviousStrike (const Voice& voice) const noexcept;
+    void resetControllers (int channel) noexcept;
+    void updateChannelGain (int channel) noexcept;
+    void setVoiceGain (int voiceIndex, float gain) noexcept;
+    ChannelState& getChannel (int channel) noexcept { return channels[(size_t) (juce::jlimit (1, 16, channel) - 1)]; }
+    void renderVoices (juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+    template <InterpolationQuality Quality>
+    void mixVoices (juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+    template <InterpolationQuality Quality>
+    void renderVoiceWith (int voiceIndex, juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+    template <typename FrameSource>
+    void renderVoiceFrom (int voiceIndex, juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                          int numFrames, FrameSource&& readFrame) noexcept;
+
+    void mixScratch (int voiceIndex, bool monoSample, float* outL, float* outR, int numSamples,
+                     float envelope, float envelopeStep) noexcept;
+    void decodeFrames (int voiceIndex, const SampleData& sample, int first, int numFrames) noexcept;
+    const int* getDecodedFrames (int voiceIndex, const SampleData& sample, int block, int endFrame) noexcept;
+
+    static constexpr int mixChunkSamples = 256;
+    static constexpr int decodeWindowFrames = 1024;
+
+    std::vector<Voice> voices;
+    MixState mix;
+    const MixKernels::Functions* kernels = &MixKernels::get();
+    std::array<float, mixChunkSamples> mixScratchL {}, mixScratchR {};   // Interpolovaný úsek hlasu před mixem
+    std::array<float, decodeWindowFrames> decodedL {}, decodedR {};     // Převedené framy int16 / int24 vzorku
+
+    // Jen se SampleStorage::Compressed: dva postupně dekódované bloky na hlas (sudý a lichý)
+    std::vector<int> decodedBlocks;                     // [hlas][slot][kanál][SampleCodec::blockFrames]
+    std::vector<SampleCodec::Decoder> blockDecoders;    // [hlas][slot]
+    std::array<ChannelState, 16> channels;
+    int minSegmentSamples = IthacaConfig::MIN_RENDER_SEGMENT_SAMPLES;
+    VoiceAllocator allocator;
+    SampleStreamer streamer;
+    const SampleLibrary* library = nullptr;
+
+    // Předávání nástroje za běhu; swapSequence je liché, dokud audio vlákno přebírá
+    std::atomic<const SampleLibrary*> pendingLibrary { nullptr };
+    std::atomic<const SampleLibrary*> activeLibrary { nullptr };
+    std::atomic<const SampleLibrary*> drainingLibrary { nullptr };
+    std::atomic<juce::uint32> swapSequence { 0 };
+    juce::uint64 drainStartOrder = 0;   // Hlasy se startOrder <= této hodnotě patří drainingLibrary
+    double currentSampleRate = 44100.0;
+    std::atomic<InterpolationQuality> interpolationQuality { InterpolationQuality::Hermite };
+    std::atomic<bool> velocityCrossfade { false };
+    std::atomic<VariantSelection> variantSelection { VariantSelection::RoundRobin };
+    std::array<juce::uint32, 128> variantCursors {};   // Na notu; jen audio vlákno
+    juce::uint32 randomState = 0x9e3779b9;             // xorshift32, nikdy 0
+    VoiceEnvelopes envelopes;
+    std::atomic<float> envelopeAttack { 0.0f }, envelopeDecay { 1.0f }, envelopeSustain { 1.0f }, envelopeRelease { 0.25f };
+    std::atomic<bool> envelopeChanged { false };
+    juce::uint64 noteCounter = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (SamplerEngine)
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "IthacaConfig.h"
+#include "Interpolator.h"
+#include "VoiceAllocator.h"
+
+/**
+ * Výběr varianty vzorku (round-robin skupiny) při opakovaných úderech noty.
+ */
+enum class VariantSelection : juce::uint8
+{
+    RoundRobin = 0,     // Varianty po řadě (kurzor na notu)
+    Random              // Náhodně (xorshift), bez opakování téže varianty po sobě
+};
+
+/**
+ * Formát, ve kterém nástroj drží PCM data v paměti (a v mmap cache).
+ */
+enum class SampleStorage : juce::uint8
+{
+    Float32 = 0,        // Dekódováno do float32 (4 bajty na vzorek)
+    Compact16,          // Cache v int16 se scale podle špičky vzorku (u 24bit zdrojů ztrátové)
+    Native,             // Bitová hloubka WAV: int16 / packed int24 bez ztráty, float zdroje jako float32
+    Compressed          // Jako Native, ale bezeztrátově komprimované bloky (SampleCodec), dekódování při renderu
+};
+
+/**
+ * Uživatelská nastavení sampleru. Mění se pouze mimo audio vlákno;
+ * engine je převezme při prepare() / načtení nástroje.
+ */
+struct SamplerSettings
+{
+    juce::File sampleDirectory = IthacaConfig::getDefaultSampleDirectory();
+    int maxVoices = IthacaConfig::MAX_VOICES;
+    VoiceAllocator::StealPolicy stealPolicy = VoiceAllocator::StealPolicy::Oldest;
+
+    // Kvalita interpolace při přehrávání s neceločíselným krokem (za cenu CPU)
+    InterpolationQuality interpolationQuality = InterpolationQuality::Hermite;
+
+    // Crossfade sousedních velocity vrstev (za cenu druhého hlasu na notu)
+    bool velocityCrossfade = false;
+
+    // ADSR obálka hlasu (VoiceEnvelopes); časy k -80 dB, release = doznívání po note-off
+    float attackSeconds = 0.0f;         // 0 = transient vzorku beze změny
+    float decaySeconds = 1.0f;
+    float sustainLevel = 1.0f;
+    float releaseSeconds = 0.25f;
+
+    // Střídání variant stejné noty a dB (pátý token názvu souboru)
+    VariantSelection variantSelection = VariantSelection::RoundRobin;
+
+    // Dopočítání chybějících not pitch-shiftem na pozadí (SampleGenerator)
+    bool generateMissingNotes = true;
+
+    // Zabalená mmap cache předdekódovaných vzorků (mimo DFD režim)
+    bool useSampleCache = true;
+
+    // Formát PCM v paměti; převod na float až při renderu hlasu (rezidentní hlavičky DFD jsou vždy float32)
+    SampleStorage sampleStorage = SampleStorage::Native;
+
+    // Direct-from-disk režim: v paměti zůstává jen začátek každého vzorku
+    bool streamFromDisk = false;
+    int preloadMilliseconds = 250;      // Délka rezidentní hlavičky vzorku
+    int streamBufferFrames = 32768;     // Velikost ring bufferu na hlas (zaokrouhleno na mocninu 2)
+    int numStreamingThreads = 2;        // Počet I/O vláken pro doplňování ringů
+
+    // Zápis celé relace logu na disk (LogJournal, čte IthacaLogDecoder)
+    bool writeLogJournal = false;
+};
@@ -0,0 +1,107 @@
+#include "VoiceAllocator.h"
+
+int VoiceAllocator::prepare (int requestedPolyphony)
+{
+    polyphony = juce::jlimit (1, maxPolyphony, requestedPolyphony);
+
+    const int numVoices = polyphony + stealReserve;
+    states.assign ((size_t) numVoices, VoiceState());
+    activeVoices.assign ((size_t) numVoices, -1);
+
+    reset();
+    return numVoices;
+}
+
+void VoiceAllocator::reset() noexcept
+{
+    noteTable.fill (-1);
+    numActive = 0;
+    numSounding = 0;
+    orderCounter = 0;
+
+    // Free list v pořadí indexů - nízké hlasy se používají přednostně
+    const int numVoices = (int) states.size();
+    for (int i = 0; i < numVoices; ++i)
+    {
+        states[(size_t) i] = VoiceState();
+        states[(size_t) i].nextFree = i + 1 < numVoices ? i + 1 : -1;
+    }
+
+    freeHead = numVoices > 0 ? 0 : -1;
+}
+
+void VoiceAllocator::activate (int voice, int channel, int midiNote, bool holdsNote) noexcept
+{
+    auto& state = states[(size_t) voice];
+    jassert (state.activeIndex < 0 && freeHead == voice);
+
+    freeHead = state.nextFree;
+    state.nextFree = -1;
+    state.channel = (juce::int16) channel;
+    state.midiNote = (juce::int16) midiNote;
+    state.startOrder = ++orderCounter;
+    state.released = false;
+    state.fading = false;
+    state.activeIndex = numActive;
+
+    activeVoices[(size_t) numActive++] = voice;
+    ++numSounding;
+
+    if (holdsNote)
+        noteTable[(size_t) tableIndex (channel, midiNote)] = (juce::int16) voice;
+}
+
+void VoiceAllocator::noteReleased (int voice) noexcept
+{
+    auto& state = states[(size_t) voice];
+    if (state.activeIndex < 0 || state.released)
+        return;
+
+    state.released = true;
+    unlinkFromTable (voice);
+}
+
+void VoiceAllocator::markFading (int voice) noexcept
+{
+    auto& state = states[(size_t) voice];
+    if (state.fading)
+        return;
+
+    state.fading = true;
+    state.released = true;
+    --numSounding;
+    unlinkFromTable (voice);
+}
+
+void VoiceAllocator::release (int voice) noexcept
+{
+    auto& state = states[(size_t) voice];
+    if (state.activeIndex < 0)
+        return;
+
+    unlinkFromTable (voice);
+
+    if (! state.fading)
+        --numSounding;
+
+    // Odebrání ze seznamu aktivních přesunem posledního prvku na uvolněné místo
+    const int last = activeVoices[(size_t) --numActive];
+    activeVoices[(size_t) state.activeIndex] = last;
+    states[(size_t) last].activeIndex = state.activeIndex;
+    activeVoices[(size_t) numActive] = -1;
+
+    state = VoiceState();
+    state.nextFree = freeHead;
+    freeHead = voice;
+}
+
+void VoiceAllocator::unlinkFromTable (int voice) noexcept
+{
+    const auto& state = states[(size_t) voice];
+    if (state.midiNote < 0)
+        return;
+
+    auto& entry = noteTable[(size_t) tableIndex (state.channel, state.midiNote)];
+    if (entry == voice)
+        entry = -1;
+}
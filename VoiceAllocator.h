@@ -0,0 +1,211 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "IthacaConfig.h"
+#include <array>
+#include <vector>
+
+/**
+ * Třída VoiceAllocator - přidělování hlasů a voice stealing (DESIGN7.md,
+ * "restart same note, LRU, intelligent voice stealing").
+ *
+ * Spravuje jen indexy do plochého pole hlasů, které vlastní engine:
+ *  - tabulka 128 not x 16 kanálů -> držený hlas pro note-off v O(1),
+ *  - intruzivní free list volných hlasů,
+ *  - hustý seznam aktivních hlasů, takže render i údržba za blok
+ *    procházejí jen znějící hlasy, ne celou polyfonii.
+ *
+ * Fyzických hlasů je o stealReserve víc než polyfonie. Ukradený hlas
+ * dozní krátkým fade-outem ve svém slotu a nová nota dostane volný hlas
+ * z rezervy; teprve když je i rezerva plná, nejstarší doznívající hlas se utne.
+ * Vše po prepare() je bez alokací a zámků (audio vlákno).
+ */
+class VoiceAllocator
+{
+public:
+    static constexpr int maxPolyphony = IthacaConfig::MAX_POLYPHONY;
+    static constexpr int stealReserve = 8;
+
+    enum class StealPolicy : juce::uint8
+    {
+        Oldest = 0,             // Nejdéle znějící hlas (LRU)
+        Quietest,               // Nejnižší aktuální úroveň obálky
+        SameNote,               // Hlas se stejnou notou, jinak nejstarší
+        ReleasePhaseFirst       // Nejdřív hlasy v release fázi (nejtišší z nich), jinak nejstarší
+    };
+
+    VoiceAllocator() = default;
+
+    // Alokace pro danou polyfonii (volat mimo audio vlákno); vrací počet fyzických hlasů
+    int prepare (int polyphony);
+
+    // Uvolnění všech hlasů
+    void reset() noexcept;
+
+    void setStealPolicy (StealPolicy newPolicy) noexcept { policy = newPolicy; }
+    StealPolicy getStealPolicy() const noexcept { return policy; }
+
+    int getPolyphony() const noexcept { return polyphony; }
+    int getNumVoices() const noexcept { return (int) states.size(); }
+    int getNumActive() const noexcept { return numActive; }
+
+    // Aktivní hlasy (hraje, release i doznívání po steal); platné do další změny
+    const int* getActiveVoices() const noexcept { return activeVoices.data(); }
+
+    // Držený (ne uvolněný) hlas pro notu na kanálu 1-16, jinak -1
+    int findHeldVoice (int channel, int midiNote) const noexcept
+    {
+        return noteTable[(size_t) tableIndex (channel, midiNote)];
+    }
+
+    /**
+     * Přidělení hlasu nové notě. Při plné polyfonii se podle politiky vybere
+     * oběť a vrátí se ve stolenVoice (engine jí nastaví rychlý fade-out);
+     * killedVoice je hlas, který se musel okamžitě utnout (engine ho zastaví).
+     * levelOf (voiceIndex) vrací aktuální úroveň hlasu pro politiku Quietest.
+     * Hlas s holdsNote = false se nezapíše do tabulky držených not (doprovodný
+     * hlas, např. druhá vrstva crossfade - note-off mu předává engine).
+     */
+    template <typename LevelFunction>
+    int allocate (int channel, int midiNote, LevelFunction&& levelOf, int& stolenVoice, int& killedVoice,
+                  bool holdsNote = true) noexcept
+    {
+        stolenVoice = -1;
+        killedVoice = -1;
+
+        if (numSounding >= polyphony)
+        {
+            stolenVoice = chooseVictim (midiNote, levelOf);
+            if (stolenVoice >= 0)
+                markFading (stolenVoice);
+        }
+
+        int voice = freeHead;
+        if (voice < 0)
+        {
+            // Rezerva je plná doznívajících hlasů - utne se nejstarší z nich
+            voice = findOldest ([this] (const VoiceState& s) { return s.fading; });
+            if (voice < 0)
+                return -1;
+
+            killedVoice = voice;
+            release (voice);
+        }
+
+        activate (voice, channel, midiNote, holdsNote);
+        return voice;
+    }
+
+    // Je volný hlas v rámci polyfonie (allocate nic neukradne ani neutne)?
+    bool hasFreeVoice() const noexcept { return numSounding < polyphony && freeHead >= 0; }
+
+    // Note-off: hlas zůstává aktivní (release), ale už není v tabulce držených not
+    void noteReleased (int voice) noexcept;
+
+    // Hlas dohrál nebo byl zastaven - zpět do free listu
+    void release (int voice) noexcept;
+
+    bool isReleased (int voice) const noexcept { return states[(size_t) voice].released; }
+    bool isFading (int voice) const noexcept { return states[(size_t) voice].fading; }
+
+private:
+    struct VoiceState
+    {
+        juce::uint64 startOrder = 0;
+        int nextFree = -1;          // Intruzivní free list
+        int activeIndex = -1;       // Pozice v activeVoices (-1 = volný)
+        juce::int16 channel = 0;
+        juce::int16 midiNote = -1;
+        bool released = false;      // Po note-off (release fáze)
+        bool fading = false;        // Ukraden, doznívá; nezapočítává se do polyfonie
+    };
+
+    static int tableIndex (int channel, int midiNote) noexcept
+    {
+        return (juce::jlimit (1, 16, channel) - 1) * 128 + (midiNote & 0x7f);
+    }
+
+    void activate (int voice, int channel, int midiNote, bool holdsNote) noexcept;
+    void markFading (int voice) noexcept;
+    void unlinkFromTable (int voice) noexcept;
+
+    template <typename Predicate>
+    int findOldest (Predicate&& predicate) const noexcept
+    {
+        int best = -1;
+        for (int i = 0; i < numActive; ++i)
+        {
+            const int voice = activeVoices[(size_t) i];
+            const auto& state = states[(size_t) voice];
+            if (predicate (state) && (best < 0 || state.startOrder < states[(size_t) best].startOrder))
+                best = voice;
+        }
+
+        return best;
+    }
+
+    template <typename LevelFunction>
+    int findQuietest (bool releasedOnly, LevelFunction& levelOf) const noexcept
+    {
+        int best = -1;
+        float bestLevel = 0.0f;
+        for (int i = 0; i < numActive; ++i)
+        {
+            const int voice = activeVoices[(size_t) i];
+            const auto& state = states[(size_t) voice];
+            if (state.fading || (releasedOnly && ! state.released))
+                continue;
+
+            const float level = levelOf (voice);
+            if (best < 0 || level < bestLevel)
+            {
+                best = voice;
+                bestLevel = level;
+            }
+        }
+
+        return best;
+    }
+
+    // Výběr oběti mezi znějícími (ne doznívajícími) hlasy - jen při plné polyfonii
+    template <typename LevelFunction>
+    int chooseVictim (int midiNote, LevelFunction& levelOf) const noexcept
+    {
+        int victim = -1;
+
+        switch (policy)
+        {
+            case StealPolicy::Quietest:
+                victim = findQuietest (false, levelOf);
+                break;
+
+            case StealPolicy::SameNote:
+                victim = findOldest ([midiNote] (const VoiceState& s) { return ! s.fading && s.midiNote == midiNote; });
+                break;
+
+            case StealPolicy::ReleasePhaseFirst:
+                victim = findQuietest (true, levelOf);
+                break;
+
+            case StealPolicy::Oldest:
+                break;
+        }
+
+        if (victim < 0)
+            victim = findOldest ([] (const VoiceState& s) { return ! s.fading; });
+
+        return victim;
+    }
+
+    std::array<juce::int16, 128 * 16> noteTable {};
+    std::vector<VoiceState> states;
+    std::vector<int> activeVoices;
+    int numActive = 0;
+    int numSounding = 0;            // Aktivní bez doznívajících (počítá se do polyfonie)
+    int freeHead = -1;
+    int polyphony = 0;
+    juce::uint64 orderCounter = 0;
+    StealPolicy policy = StealPolicy::Oldest;
+
+    JUCE_DECLARE_NON_COPYABLE (VoiceAllocator)
+};
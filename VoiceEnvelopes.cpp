@@ -0,0 +1,171 @@
+#include "VoiceEnvelopes.h"
+#include <cmath>
+
+void VoiceEnvelopes::prepare (int numVoices, double newSampleRate, double stealFadeSeconds)
+{
+    sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+
+    const auto size = (size_t) juce::jmax (0, numVoices);
+    levels.assign (size, 0.0f);
+    blockStarts.assign (size, 0.0f);
+    targets.assign (size, 0.0f);
+    coefficients.assign (size, 1.0f);
+    multipliers.assign (size, 1.0f);
+    powers.assign (size, 1.0f);
+    stages.assign (size, Idle);
+
+    stealCoefficient = coefficientFor (stealFadeSeconds, silenceLevel);
+    setParameters (attackTime, decayTime, sustainLevel, releaseTime);
+}
+
+void VoiceEnvelopes::setParameters (float attackSeconds, float decaySeconds, float newSustainLevel, float releaseSeconds) noexcept
+{
+    attackTime = juce::jmax (0.0f, attackSeconds);
+    decayTime = juce::jmax (0.0f, decaySeconds);
+    sustainLevel = juce::jlimit (0.0f, 1.0f, newSustainLevel);
+    releaseTime = juce::jmax (0.0f, releaseSeconds);
+
+    // Attack: z 0 na 1 při cíli attackTarget = zbývá 1 - 1/attackTarget vzdálenosti
+    attackCoefficient = coefficientFor (attackTime, 1.0 - 1.0 / attackTarget);
+    decayCoefficient = coefficientFor (decayTime, silenceLevel);
+    releaseCoefficient = coefficientFor (releaseTime, silenceLevel);
+}
+
+float VoiceEnvelopes::coefficientFor (double seconds, double remaining) const noexcept
+{
+    const double numSamples = juce::jmax (1.0, seconds * sampleRate);
+    return (float) std::exp (std::log (remaining) / numSamples);
+}
+
+void VoiceEnvelopes::start (int voice) noexcept
+{
+    const auto i = (size_t) voice;
+
+    // Bez attacku hned na plné úrovni - transient vzorku se nerozmaže rampou segmentu
+    if (attackTime <= 0.0f)
+    {
+        levels[i] = 1.0f;
+        blockStarts[i] = 1.0f;
+        targets[i] = sustainLevel;
+        coefficients[i] = decayCoefficient;
+        stages[i] = Decay;
+        return;
+    }
+
+    levels[i] = 0.0f;
+    blockStarts[i] = 0.0f;
+    targets[i] = attackTarget;
+    coefficients[i] = attackCoefficient;
+    stages[i] = Attack;
+}
+
+void VoiceEnvelopes::release (int voice) noexcept
+{
+    enterRelease (voice, releaseCoefficient);
+}
+
+void VoiceEnvelopes::fadeOut (int voice) noexcept
+{
+    enterRelease (voice, stealCoefficient);
+}
+
+void VoiceEnvelopes::enterRelease (int voice, float coefficient) noexcept
+{
+    const auto i = (size_t) voice;
+    if (stages[i] == Idle)
+        return;
+
+    // Už běžící release se nezpomalí (menší koeficient = rychlejší pokles)
+    coefficients[i] = stages[i] == Release ? juce::jmin (coefficients[i], coefficient) : coefficient;
+    targets[i] = 0.0f;
+    stages[i] = Release;
+}
+
+void VoiceEnvelopes::setReleaseSpeed (int voice, float speed) noexcept
+{
+    const auto i = (size_t) voice;
+    if (stages[i] == Idle || (speed <= 0.0f && stages[i] != Release))
+        return;
+
+    coefficients[i] = speed <= 0.0f ? 1.0f : std::pow (releaseCoefficient, juce::jmin (1.0f, speed));
+    targets[i] = 0.0f;
+    stages[i] = Release;
+}
+
+void VoiceEnvelopes::stop (int voice) noexcept
+{
+    const auto i = (size_t) voice;
+    levels[i] = 0.0f;
+    blockStarts[i] = 0.0f;
+    targets[i] = 0.0f;
+    coefficients[i] = 1.0f;
+    stages[i] = Idle;
+}
+
+void VoiceEnvelopes::stopAll() noexcept
+{
+    for (int i = 0; i < (int) stages.size(); ++i)
+        stop (i);
+}
+
+/**
+ * Posun obálek aktivních hlasů o segment. Koeficienty se sbalí do souvislého
+ * pole (multipliers / powers podle pořadí ve voiceIndices), umocňování běží
+ * bez větvení nad ním a výsledek se zapíše zpět do slotů hlasů. Nečinné
+ * sloty se neprochází (jejich úroveň zůstává 0 ze stop / konce release).
+ */
+void VoiceEnvelopes::process (const int* voiceIndices, int numVoices, int numSamples) noexcept
+{
+    numVoices = juce::jmin (numVoices, (int) stages.size());
+    if (numSamples <= 0 || numVoices <= 0)
+        return;
+
+    float* level = levels.data();
+    float* start = blockStarts.data();
+    float* multiplier = multipliers.data();
+    float* power = powers.data();
+    const float* target = targets.data();
+    const float* coefficient = coefficients.data();
+
+    // coefficient^numSamples umocňováním na druhou - stejné bity n pro všechny hlasy
+    for (int k = 0; k < numVoices; ++k)
+    {
+        multiplier[k] = 1.0f;
+        power[k] = coefficient[voiceIndices[k]];
+    }
+
+    for (int remaining = numSamples; remaining > 0; remaining >>= 1)
+    {
+        if ((remaining & 1) != 0)
+            for (int k = 0; k < numVoices; ++k)
+                multiplier[k] *= power[k];
+
+        if (remaining > 1)
+            for (int k = 0; k < numVoices; ++k)
+                power[k] *= power[k];
+    }
+
+    for (int k = 0; k < numVoices; ++k)
+    {
+        const int i = voiceIndices[k];
+        start[i] = level[i];
+        level[i] = target[i] + (level[i] - target[i]) * multiplier[k];
+
+        // Přechody fází - jen porovnání, mění se málokdy
+        const auto stage = stages[(size_t) i];
+
+        if (stage == Attack && level[i] >= 1.0f)
+        {
+            level[i] = 1.0f;
+            targets[(size_t) i] = sustainLevel;
+            coefficients[(size_t) i] = decayCoefficient;
+            stages[(size_t) i] = Decay;
+        }
+        else if (stage == Release && level[i] <= silenceLevel)
+        {
+            level[i] = 0.0f;
+            coefficients[(size_t) i] = 1.0f;
+            stages[(size_t) i] = Idle;
+        }
+    }
+}
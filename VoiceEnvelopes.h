@@ -0,0 +1,102 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <vector>
+
+/**
+ * Třída VoiceEnvelopes - ADSR obálky všech hlasů ve tvaru structure-of-arrays.
+ *
+ * Úroveň, cíl, koeficient a fáze každého hlasu leží v samostatných polích
+ * indexovaných stejně jako hlasy enginu. process() posune obálky aktivních
+ * hlasů (seznam z VoiceAllocator) o celý segment najednou: úroveň se
+ * exponenciálně blíží cíli,
+ *
+ *   level(n) = target + (level - target) * coefficient^n,
+ *
+ * kde coefficient^n se počítá umocňováním na druhou (log2 n násobení pro
+ * všechny hlasy společně) nad koeficienty sbalenými do souvislého pole.
+ * Smyčky umocňování jsou bez větvení, takže je kompilátor vektorizuje,
+ * a cena nezávisí na počtu nečinných slotů. Hlas pak v rámci segmentu
+ * lineárně interpoluje mezi getBlockStart() a getBlockEnd() - žádné pow
+ * ani exp na vzorek.
+ *
+ * Attack míří nad 1 (na attackTarget) a končí při dosažení 1, takže má
+ * konečnou délku a obvyklý tvar. Decay se blíží sustainu a zůstává v něm.
+ * Release i rychlý fade-out ukradeného hlasu míří k nule; obálka končí pod
+ * silenceLevel (-80 dB). Časy se měří právě k těmto prahům, takže release
+ * time je skutečná délka doznívání po note-off. Fáze kratší než segment
+ * se v něm rozprostře do lineární rampy; attack 0 proto začíná rovnou na 1.
+ *
+ * Vše po prepare() volá jen audio vlákno a nic nealokuje. Nové parametry
+ * ADSR se projeví od další změny fáze (nota, note-off).
+ */
+class VoiceEnvelopes
+{
+public:
+    static constexpr float silenceLevel = 1.0e-4f;     // -80 dB - konec release
+    static constexpr float attackTarget = 1.5f;        // Attack končí na 1 (2/3 cesty k cíli)
+
+    enum Stage : juce::uint8
+    {
+        Idle = 0,
+        Attack,
+        Decay,          // Včetně sustainu (blíží se sustainLevel a zůstává v něm)
+        Release
+    };
+
+    VoiceEnvelopes() = default;
+
+    // Alokace pro daný počet hlasů (mimo audio vlákno)
+    void prepare (int numVoices, double sampleRate, double stealFadeSeconds);
+
+    void setParameters (float attackSeconds, float decaySeconds, float sustainLevel, float releaseSeconds) noexcept;
+    float getReleaseSeconds() const noexcept { return releaseTime; }
+
+    // Nová nota: obálka od nuly
+    void start (int voice) noexcept;
+
+    // Note-off: release nejvýš tak pomalý jako nastavený release time
+    void release (int voice) noexcept;
+
+    // Ukradený hlas: release nejvýš tak pomalý jako steal fade
+    void fadeOut (int voice) noexcept;
+
+    /**
+     * Release s rychlostí speed (0-1) vůči release time - doznívání pod
+     * half-pedal; nastaví se přesně (zpomalí i zrychlí). speed 0 release
+     * zastaví (úroveň drží) a obálce před release fázi nemění.
+     */
+    void setReleaseSpeed (int voice, float speed) noexcept;
+
+    // Okamžité ukončení (reset, utnutý hlas)
+    void stop (int voice) noexcept;
+    void stopAll() noexcept;
+
+    // Posun obálek hlasů voiceIndices[0 .. numVoices) o numSamples vzorků
+    void process (const int* voiceIndices, int numVoices, int numSamples) noexcept;
+
+    float getLevel (int voice) const noexcept       { return levels[(size_t) voice]; }
+    float getBlockStart (int voice) const noexcept  { return blockStarts[(size_t) voice]; }
+    float getBlockEnd (int voice) const noexcept    { return levels[(size_t) voice]; }
+    bool isFinished (int voice) const noexcept      { return stages[(size_t) voice] == Idle; }
+    Stage getStage (int voice) const noexcept       { return (Stage) stages[(size_t) voice]; }
+
+private:
+    // Koeficient exponenciály, která za seconds urazí podíl remaining vzdálenosti k cíli
+    float coefficientFor (double seconds, double remaining) const noexcept;
+    void enterRelease (int voice, float coefficient) noexcept;
+
+    std::vector<float> levels;          // Úroveň na konci posledního segmentu
+    std::vector<float> blockStarts;     // Úroveň na začátku posledního segmentu
+    std::vector<float> targets;
+    std::vector<float> coefficients;    // Násobek vzdálenosti k cíli za vzorek (1 = stojí)
+    std::vector<float> multipliers;     // coefficient^n pro aktuální segment (sbaleně podle pořadí v process)
+    std::vector<float> powers;          // Mezivýsledek umocňování (sbaleně)
+    std::vector<juce::uint8> stages;
+
+    double sampleRate = 44100.0;
+    float attackTime = 0.0f, decayTime = 1.0f, sustainLevel = 1.0f, releaseTime = 0.25f;
+    float attackCoefficient = 0.0f, decayCoefficient = 0.0f, releaseCoefficient = 0.0f, stealCoefficient = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE (VoiceEnvelopes)
+};